@@ -0,0 +1,21 @@
+# Runs the benchmark executables and collects their JSON lines.
+#
+# cmake -D RESULTS=<file> -D EVENTS=<n> -D BENCHMARKS="<exe>;<exe>..." -P RunBenchmarks.cmake
+
+file(WRITE ${RESULTS} "")
+
+foreach(benchmark IN LISTS BENCHMARKS)
+    execute_process(
+        COMMAND ${benchmark} ${EVENTS}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result)
+
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${benchmark} failed: ${result}")
+    endif()
+
+    message(STATUS "${output}")
+    file(APPEND ${RESULTS} "${output}")
+endforeach()
+
+message(STATUS "Results written to ${RESULTS}")
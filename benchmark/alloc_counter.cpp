@@ -0,0 +1,23 @@
+/**
+ * @file alloc_counter.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Replaces the global allocation functions to count allocations
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#define FSM_ALLOCATION_HOOK_IMPLEMENTATION
+#include <base/allocation_hook.h>
+
+#include "bench.h"
+
+std::size_t escad::bench::allocations() noexcept {
+  return escad::thread_allocation_stats().allocations;
+}
+
+std::size_t escad::bench::allocated_bytes() noexcept {
+  return escad::thread_allocation_stats().bytes;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file bench.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Minimal harness shared by the fsm benchmarks
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+namespace escad::bench {
+
+/**
+ * @brief Number of calls to the global operator new of this thread so far.
+ *
+ * Implemented in alloc_counter.cpp on top of base/allocation_hook.h, which
+ * replaces the global allocation functions of the benchmark executables.
+ */
+std::size_t allocations() noexcept;
+
+/**
+ * @brief Number of bytes requested from the global operator new of this
+ * thread so far.
+ */
+std::size_t allocated_bytes() noexcept;
+
+/**
+ * @brief Keeps the compiler from optimizing away a value.
+ */
+template <class Type> inline void do_not_optimize(Type const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static_cast<void>(*static_cast<const volatile char *>(
+      static_cast<const volatile void *>(&value)));
+#endif
+}
+
+/**
+ * @brief Command line of a benchmark executable.
+ *
+ * Usage: <executable> [events]
+ */
+struct options {
+  options(int argc, char *argv[])
+      : events{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000ull},
+        binary_size{0u} {
+    std::error_code ec;
+    binary_size = std::filesystem::file_size("/proc/self/exe", ec);
+    if (ec && argc > 0) {
+      binary_size = std::filesystem::file_size(argv[0], ec);
+    }
+    if (ec) {
+      binary_size = 0u;
+    }
+  }
+
+  std::size_t events;
+  std::uintmax_t binary_size;
+};
+
+struct result {
+  std::string_view engine;
+  std::string_view scenario;
+  std::size_t events;
+  std::size_t transitions;
+  std::size_t allocations;
+  double seconds;
+};
+
+/**
+ * @brief Runs a scenario.
+ *
+ * func(count) has to dispatch count events. It is run once with a tenth of
+ * the events as warm-up, so lazily created states and buffers are not
+ * accounted to the steady state.
+ *
+ * @param engine Name of the engine.
+ * @param scenario Name of the scenario.
+ * @param events Number of events to dispatch.
+ * @param transitions Number of transitions the events result in.
+ * @param func Dispatch loop.
+ * @return result
+ */
+template <class Func>
+result run(std::string_view engine, std::string_view scenario,
+           std::size_t events, std::size_t transitions, Func &&func) {
+  func(events / 10u + 1u);
+
+  const auto allocs = allocations();
+  const auto start = std::chrono::steady_clock::now();
+
+  func(events);
+
+  const auto stop = std::chrono::steady_clock::now();
+
+  return {engine,
+          scenario,
+          events,
+          transitions,
+          allocations() - allocs,
+          std::chrono::duration<double>(stop - start).count()};
+}
+
+/**
+ * @brief Prints a result as one JSON object per line.
+ */
+inline void report(const options &opts, const result &res) {
+  const auto events = static_cast<double>(res.events);
+
+  std::printf("{\"engine\":\"%.*s\",\"scenario\":\"%.*s\",\"events\":%zu,"
+              "\"ns_per_event\":%.3f,\"transitions_per_s\":%.0f,"
+              "\"allocs_per_event\":%.6f,\"binary_size\":%ju}\n",
+              static_cast<int>(res.engine.size()), res.engine.data(),
+              static_cast<int>(res.scenario.size()), res.scenario.data(),
+              res.events, res.seconds * 1e9 / events,
+              static_cast<double>(res.transitions) / res.seconds,
+              static_cast<double>(res.allocations) / events,
+              opts.binary_size);
+  std::fflush(stdout);
+}
+
+/**
+ * @brief Prints the memory footprint of a type as one JSON object per line.
+ *
+ * @param opts Options of the benchmark.
+ * @param engine Name of the engine.
+ * @param scenario Name of the scenario.
+ * @param object_size Size of an instance, i.e. sizeof.
+ * @param heap_bytes Heap memory allocated per instance.
+ * @param allocs Number of allocations per instance.
+ */
+inline void report_footprint(const options &opts, std::string_view engine,
+                             std::string_view scenario,
+                             std::size_t object_size, double heap_bytes,
+                             double allocs) {
+  std::printf("{\"engine\":\"%.*s\",\"scenario\":\"%.*s\","
+              "\"object_size\":%zu,\"heap_bytes\":%.1f,"
+              "\"allocs_per_instance\":%.3f,\"binary_size\":%ju}\n",
+              static_cast<int>(engine.size()), engine.data(),
+              static_cast<int>(scenario.size()), scenario.data(), object_size,
+              heap_bytes, allocs, opts.binary_size);
+  std::fflush(stdout);
+}
+
+/**
+ * @brief Prints the latency distribution of single operations as one JSON
+ * object per line.
+ *
+ * @param opts Options of the benchmark.
+ * @param engine Name of the engine.
+ * @param scenario Name of the scenario.
+ * @param events Number of operations measured.
+ * @param mean_ns Mean latency in nanoseconds.
+ * @param p999_ns 99.9th percentile of the latency in nanoseconds.
+ * @param max_ns Worst latency in nanoseconds.
+ */
+inline void report_latency(const options &opts, std::string_view engine,
+                           std::string_view scenario, std::size_t events,
+                           double mean_ns, double p999_ns, double max_ns) {
+  std::printf("{\"engine\":\"%.*s\",\"scenario\":\"%.*s\",\"events\":%zu,"
+              "\"mean_ns\":%.1f,\"p999_ns\":%.1f,\"max_ns\":%.1f,"
+              "\"binary_size\":%ju}\n",
+              static_cast<int>(engine.size()), engine.data(),
+              static_cast<int>(scenario.size()), scenario.data(), events,
+              mean_ns, p999_ns, max_ns, opts.binary_size);
+  std::fflush(stdout);
+}
+
+} // namespace escad::bench
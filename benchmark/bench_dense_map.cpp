@@ -0,0 +1,199 @@
+/**
+ * @file bench_dense_map.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Lookup latency of dense_map with chained buckets versus control
+ * bytes, at several load factors, one key at a time and in batches, with
+ * full and 32-bit indices, and worst-case insertion latency with and without
+ * incremental rehash
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <container/dense_map.h>
+
+#include "bench.h"
+
+namespace {
+
+// large enough not to fit the caches, so that every probe counts
+constexpr std::size_t bucket_count = 1u << 20u;
+constexpr std::size_t batch_size = 256u;
+
+template <class Layout, class Index>
+using map_type =
+    escad::dense_map<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>,
+                     std::equal_to<std::uint64_t>,
+                     std::allocator<std::pair<const std::uint64_t, std::uint64_t>>,
+                     Layout, Index>;
+
+// keys spread over the whole range, as if hashed by the caller
+std::vector<std::uint64_t> make_keys(const std::size_t count,
+                                     std::uint64_t seed) {
+  std::vector<std::uint64_t> keys(count);
+
+  for (auto &&key : keys) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    key = seed ^ (seed >> 29u);
+  }
+
+  return keys;
+}
+
+// lookups in random order, not in the order of the packed array
+std::vector<std::uint64_t> shuffle(std::vector<std::uint64_t> keys,
+                                   std::uint64_t seed) {
+  for (auto pos = keys.size(); pos > 1u; --pos) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    std::swap(keys[pos - 1u], keys[(seed >> 33u) % pos]);
+  }
+
+  return keys;
+}
+
+template <class Layout, class Index>
+void find(const escad::bench::options &opts, std::string_view engine,
+          const float load_factor) {
+  const auto count =
+      static_cast<std::size_t>(static_cast<float>(bucket_count) * load_factor);
+  const auto keys = make_keys(count, 1u);
+  const auto hits = shuffle(keys, 3u);
+  const auto missing = make_keys(count, 2u);
+  map_type<Layout, Index> map;
+
+  map.reserve(count);
+  map.rehash(bucket_count);
+
+  for (auto &&key : keys) {
+    map.emplace(key, key);
+  }
+
+  char suffix[8u];
+  std::snprintf(suffix, sizeof(suffix), "%.3f",
+                static_cast<double>(map.load_factor()));
+
+  const std::pair<const char *, const std::vector<std::uint64_t> *>
+      scenarios[]{{"find_hit_", &hits}, {"find_miss_", &missing}};
+
+  for (auto &&[scenario, source] : scenarios) {
+    const auto name = scenario + std::string{suffix};
+    std::uint64_t sum{};
+
+    const auto res = escad::bench::run(
+        engine, name, opts.events, opts.events, [&](std::size_t n) {
+          for (std::size_t pos{}; pos < n; ++pos) {
+            const auto it = map.find((*source)[pos % count]);
+            sum += (it != map.end()) ? it->second : 1u;
+          }
+        });
+
+    escad::bench::do_not_optimize(sum);
+    escad::bench::report(opts, res);
+  }
+
+  // same lookups, a batch at a time
+  std::vector<typename map_type<Layout, Index>::iterator> found(batch_size);
+
+  for (auto &&[scenario, source] : scenarios) {
+    const auto name = "find_batch_" + std::string{scenario + 5} + suffix;
+    std::uint64_t sum{};
+
+    const auto res = escad::bench::run(
+        engine, name, opts.events, opts.events, [&](std::size_t n) {
+          for (std::size_t pos{}; pos < n; pos += batch_size) {
+            const auto offset = pos % count;
+            const auto size = std::min({batch_size, n - pos, count - offset});
+            const auto first = source->begin() + static_cast<std::ptrdiff_t>(offset);
+            map.find_batch(first, first + static_cast<std::ptrdiff_t>(size),
+                           found.begin());
+
+            for (std::size_t elem{}; elem < size; ++elem) {
+              sum += (found[elem] != map.end()) ? found[elem]->second : 1u;
+            }
+          }
+        });
+
+    escad::bench::do_not_optimize(sum);
+    escad::bench::report(opts, res);
+  }
+}
+
+template <class Layout, class Index = std::size_t>
+void run_all(const escad::bench::options &opts, std::string_view engine) {
+  for (const float load_factor : {0.25f, 0.5f, 0.875f}) {
+    find<Layout, Index>(opts, engine, load_factor);
+  }
+}
+
+// every insertion timed on its own, the index grows from the minimum number
+// of buckets so that the worst case is the insertion that triggers the last
+// rehash, unless reserved upfront as a baseline for the noise of the machine
+template <class Layout>
+void insert_latency(const escad::bench::options &opts,
+                    std::string_view engine, const bool grow = true) {
+  using clock = std::chrono::steady_clock;
+  const auto keys = make_keys(opts.events, 4u);
+  std::vector<double> latency(keys.size());
+  map_type<Layout, std::size_t> map;
+
+  // the packed array would move all the elements when it grows, only the
+  // index is measured
+  map.reserve(keys.size());
+
+  if (grow) {
+    map.rehash(0u);
+  }
+
+  for (std::size_t pos{}; pos < keys.size(); ++pos) {
+    const auto start = clock::now();
+    map.emplace(keys[pos], keys[pos]);
+    const auto stop = clock::now();
+    latency[pos] =
+        std::chrono::duration<double, std::nano>(stop - start).count();
+  }
+
+  escad::bench::do_not_optimize(map.size());
+
+  double total{};
+
+  for (auto &&elem : latency) {
+    total += elem;
+  }
+
+  const auto last = latency.size() - 1u;
+  const auto p999 =
+      latency.begin() + static_cast<std::ptrdiff_t>(last - last / 1000u);
+  std::nth_element(latency.begin(), p999, latency.end());
+  const auto max = *std::max_element(p999, latency.end());
+
+  escad::bench::report_latency(opts, engine, "insert_latency", latency.size(),
+                               total / static_cast<double>(latency.size()),
+                               *p999, max);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  run_all<escad::chained_buckets>(opts, "dense_map_chained");
+  run_all<escad::control_bytes>(opts, "dense_map_control");
+  run_all<escad::chained_buckets, std::uint32_t>(opts, "dense_map_chained_u32");
+  run_all<escad::control_bytes, std::uint32_t>(opts, "dense_map_control_u32");
+  insert_latency<escad::chained_buckets>(opts, "dense_map_reserved", false);
+  insert_latency<escad::chained_buckets>(opts, "dense_map_chained");
+  insert_latency<escad::incremental_buckets>(opts, "dense_map_incremental");
+  return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file bench_emitter.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Publish latency of emitter versus static_emitter
+ * @version 0.1
+ * @date 2024-04-22
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cstddef>
+
+#include <signal/emitter.h>
+#include <signal/static_emitter.h>
+
+#include "bench.h"
+
+namespace {
+
+struct ping {
+  int value;
+};
+
+struct pong {
+  int value;
+};
+
+struct idle {};
+
+struct dynamic_emitter : escad::emitter<dynamic_emitter> {
+  long long sum{};
+};
+
+struct closed_emitter : escad::static_emitter<closed_emitter, ping, pong, idle> {
+  long long sum{};
+};
+
+template <class Emitter>
+void publish(const escad::bench::options &opts, std::string_view engine) {
+  Emitter emitter;
+  emitter.template on<ping>(
+      [](ping &event, Emitter &owner) { owner.sum += event.value; });
+  emitter.template on<pong>(
+      [](pong &event, Emitter &owner) { owner.sum -= event.value; });
+
+  const auto res = escad::bench::run(
+      engine, "publish", opts.events, opts.events, [&](std::size_t n) {
+        for (std::size_t pos{}; pos < n; ++pos) {
+          const auto value = static_cast<int>(pos);
+
+          if (pos & 1u) {
+            emitter.publish(pong{value});
+          } else {
+            emitter.publish(ping{value});
+          }
+        }
+      });
+
+  escad::bench::do_not_optimize(emitter.sum);
+  escad::bench::report(opts, res);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  publish<dynamic_emitter>(opts, "emitter");
+  publish<closed_emitter>(opts, "static_emitter");
+  return 0;
+}
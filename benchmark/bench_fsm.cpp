@@ -0,0 +1,122 @@
+/**
+ * @file bench_fsm.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Benchmark scenarios for escad::fsm::fsm
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include <fsm/fsm.h>
+
+#include "bench.h"
+#include "scenarios.h"
+
+using namespace escad::bench::scenario;
+
+namespace pingpong {
+
+struct B;
+
+struct A {
+  B transitionTo(const ping &) const;
+  B transitionTo(const heavy &) const;
+  void onEnter(const heavy &event) { payload_sink += event.samples[0]; }
+};
+
+struct B {
+  A transitionTo(const ping &) const;
+  A transitionTo(const heavy &) const;
+  void onEnter(const heavy &event) { payload_sink += event.samples[1]; }
+};
+
+B A::transitionTo(const ping &) const { return {}; }
+B A::transitionTo(const heavy &) const { return {}; }
+A B::transitionTo(const ping &) const { return {}; }
+A B::transitionTo(const heavy &) const { return {}; }
+
+using machine = escad::fsm::fsm<std::variant<A, B>>;
+
+} // namespace pingpong
+
+namespace ring {
+
+template <std::size_t I> struct ring_state {
+  ring_state<(I + 1u) % ring_size> transitionTo(const next &) const {
+    return {};
+  }
+};
+
+template <class> struct ring_variant;
+
+template <std::size_t... I> struct ring_variant<std::index_sequence<I...>> {
+  using type = std::variant<ring_state<I>...>;
+};
+
+using machine = escad::fsm::fsm<
+    typename ring_variant<std::make_index_sequence<ring_size>>::type>;
+
+} // namespace ring
+
+namespace deep {
+
+// fsm::fsm has no hierarchy, each level is a state owning the machine of the
+// level below and forwarding the events to it.
+
+struct leaf_b;
+
+struct leaf_a {
+  leaf_b transitionTo(const toggle &) const;
+};
+
+struct leaf_b {
+  leaf_a transitionTo(const toggle &) const;
+};
+
+leaf_b leaf_a::transitionTo(const toggle &) const { return {}; }
+leaf_a leaf_b::transitionTo(const toggle &) const { return {}; }
+
+template <class InnerVariant, class Initial> struct composite {
+  composite() : inner{Initial{}} {}
+
+  std::nullopt_t handle(const toggle &event) {
+    inner.dispatch(event);
+    return std::nullopt;
+  }
+
+  escad::fsm::fsm<InnerVariant> inner;
+};
+
+using level4 = composite<std::variant<leaf_a, leaf_b>, leaf_a>;
+using level3 = composite<std::variant<level4>, level4>;
+using level2 = composite<std::variant<level3>, level3>;
+using level1 = composite<std::variant<level2>, level2>;
+
+using machine = escad::fsm::fsm<std::variant<level1>>;
+
+} // namespace deep
+
+struct factory {
+  auto ping_pong() const {
+    return std::make_unique<pingpong::machine>(pingpong::A{});
+  }
+
+  auto ring() const {
+    return std::make_unique<ring::machine>(ring::ring_state<0>{});
+  }
+
+  auto deep() const { return std::make_unique<deep::machine>(deep::level1{}); }
+};
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  run_all(opts, "fsm", factory{});
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_fsmpp17.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Benchmark scenarios for escad::state_machine (fsmpp17)
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <memory>
+#include <utility>
+
+#include <fsmpp17/fsm.h>
+
+#include "bench.h"
+#include "scenarios.h"
+
+using namespace escad::bench::scenario;
+
+struct empty_context {};
+
+namespace pingpong {
+
+struct B;
+
+struct A : escad::state<> {
+  auto handle(const ping &) const { return transition<B>(); }
+
+  auto handle(const heavy &event) const {
+    payload_sink += event.samples[0];
+    return transition<B>();
+  }
+};
+
+struct B : escad::state<> {
+  auto handle(const ping &) const { return transition<A>(); }
+
+  auto handle(const heavy &event) const {
+    payload_sink += event.samples[1];
+    return transition<A>();
+  }
+};
+
+using states = escad::states<A, B>;
+using events = escad::events<ping, noise, heavy>;
+using machine = escad::state_machine<states, events, empty_context>;
+
+} // namespace pingpong
+
+namespace ring {
+
+template <std::size_t I> struct ring_state : escad::state<> {
+  auto handle(const next &) const {
+    return transition<ring_state<(I + 1u) % ring_size>>();
+  }
+};
+
+template <class> struct ring_states;
+
+template <std::size_t... I> struct ring_states<std::index_sequence<I...>> {
+  using type = escad::states<ring_state<I>...>;
+};
+
+using states = typename ring_states<std::make_index_sequence<ring_size>>::type;
+using events = escad::events<next>;
+using machine = escad::state_machine<states, events, empty_context>;
+
+} // namespace ring
+
+namespace deep {
+
+struct leaf_b;
+
+struct leaf_a : escad::state<> {
+  auto handle(const toggle &) const { return transition<leaf_b>(); }
+};
+
+struct leaf_b : escad::state<> {
+  auto handle(const toggle &) const { return transition<leaf_a>(); }
+};
+
+struct level4 : escad::state<leaf_a, leaf_b> {};
+struct level3 : escad::state<level4> {};
+struct level2 : escad::state<level3> {};
+struct level1 : escad::state<level2> {};
+
+using states = escad::states<level1>;
+using events = escad::events<toggle>;
+using machine = escad::state_machine<states, events, empty_context>;
+
+} // namespace deep
+
+struct factory {
+  auto ping_pong() const { return std::make_unique<pingpong::machine>(); }
+
+  auto ring() const { return std::make_unique<ring::machine>(); }
+
+  auto deep() const { return std::make_unique<deep::machine>(); }
+};
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  run_all(opts, "fsmpp17", factory{});
+  return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file bench_new_fsm.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Benchmark scenarios for escad::new_fsm::StateMachine
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <memory>
+#include <utility>
+
+#include <new_fsm/composite_state.h>
+#include <new_fsm/state.h>
+#include <new_fsm/state_machine.h>
+
+#include "bench.h"
+#include "scenarios.h"
+
+using namespace escad::bench::scenario;
+using namespace escad::new_fsm;
+
+using context = detail::NoContext;
+
+template <class States>
+auto make_machine() {
+  return std::make_unique<StateMachine<States, context>>(
+      mpl::type_identity<States>{}, context{});
+}
+
+namespace pingpong {
+
+struct B;
+
+struct A : state<A> {
+  using state::state;
+
+  auto transitionTo(const ping &) { return sibling<B>(); }
+  auto transitionTo(const heavy &) { return sibling<B>(); }
+  void onEnter(const heavy &event) { payload_sink += event.samples[0]; }
+};
+
+struct B : state<B> {
+  using state::state;
+
+  auto transitionTo(const ping &) { return sibling<A>(); }
+  auto transitionTo(const heavy &) { return sibling<A>(); }
+  void onEnter(const heavy &event) { payload_sink += event.samples[1]; }
+};
+
+using states_type = states<A, B>;
+
+} // namespace pingpong
+
+namespace ring {
+
+template <std::size_t I> struct ring_state : state<ring_state<I>> {
+  using state<ring_state<I>>::state;
+
+  auto transitionTo(const next &) {
+    return sibling<ring_state<(I + 1u) % ring_size>>();
+  }
+};
+
+template <class> struct ring_states;
+
+template <std::size_t... I> struct ring_states<std::index_sequence<I...>> {
+  using type = states<ring_state<I>...>;
+};
+
+using states_type =
+    typename ring_states<std::make_index_sequence<ring_size>>::type;
+
+} // namespace ring
+
+namespace deep {
+
+struct leaf_b;
+
+struct leaf_a : state<leaf_a> {
+  using state::state;
+
+  auto transitionTo(const toggle &) { return sibling<leaf_b>(); }
+};
+
+struct leaf_b : state<leaf_b> {
+  using state::state;
+
+  auto transitionTo(const toggle &) { return sibling<leaf_a>(); }
+};
+
+/**
+ * @brief Composite state whose nested machine starts in Initial.
+ */
+template <class Derived, class NestedStates, class Initial>
+struct level : composite_state<Derived, StateMachine<NestedStates, context>> {
+  using nested_type = StateMachine<NestedStates, context>;
+
+  level(context &ctx)
+      : composite_state<Derived, nested_type>{
+            ctx, nested_type{mpl::type_identity<NestedStates>{},
+                             context{}}} {
+    this->template nested_emplace<Initial>();
+  }
+};
+
+struct level4 : level<level4, states<leaf_a, leaf_b>, leaf_a> {
+  using level::level;
+};
+
+struct level3 : level<level3, states<level4>, level4> {
+  using level::level;
+};
+
+struct level2 : level<level2, states<level3>, level3> {
+  using level::level;
+};
+
+struct level1 : level<level1, states<level2>, level2> {
+  using level::level;
+};
+
+using states_type = states<level1>;
+
+} // namespace deep
+
+struct factory {
+  auto ping_pong() const {
+    auto machine = make_machine<pingpong::states_type>();
+    machine->emplace<pingpong::A>();
+    return machine;
+  }
+
+  auto ring() const {
+    auto machine = make_machine<ring::states_type>();
+    machine->emplace<ring::ring_state<0>>();
+    return machine;
+  }
+
+  auto deep() const {
+    auto machine = make_machine<deep::states_type>();
+    machine->emplace<deep::level1>();
+    return machine;
+  }
+};
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  run_all(opts, "new_fsm", factory{});
+  return 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file bench_signal.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Footprint and publish latency of signal versus small_signal, one
+ * event at a time and in batches, connection churn with and without the check
+ * for duplicates, and publish latency of static_signal
+ * @version 0.1
+ * @date 2024-04-08
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <signal/signal.h>
+#include <signal/static_signal.h>
+
+#include "bench.h"
+
+namespace {
+
+constexpr std::size_t inline_size = 3u;
+constexpr std::size_t instances = 10'000u;
+constexpr std::size_t batch_size = 256u;
+constexpr std::size_t churn_size = 1'000u;
+
+struct listener {
+  void receive(int value) { sum += value; }
+
+  long long sum{};
+};
+
+// free functions for static signals, one accumulator each
+long long static_sums[8u]{};
+
+template <std::size_t Index>
+void receive(int value) {
+  static_sums[Index] += value;
+}
+
+template <std::size_t... Index>
+auto make_static_signal(std::index_sequence<Index...>)
+    -> escad::static_signal<void(int), &receive<Index>...>;
+
+template <std::size_t Count>
+using static_signal_for =
+    decltype(make_static_signal(std::make_index_sequence<Count>{}));
+
+template <class Signal>
+void connect(Signal &signal, std::vector<listener> &listeners) {
+  escad::slot slot{signal};
+
+  for (auto &elem : listeners) {
+    slot.template connect<&listener::receive>(elem);
+  }
+}
+
+template <class Signal>
+void footprint(const escad::bench::options &opts, std::string_view engine,
+               std::size_t count) {
+  std::vector<listener> listeners(count);
+  std::vector<Signal> signals;
+  signals.reserve(instances);
+
+  const auto allocs = escad::bench::allocations();
+  const auto bytes = escad::bench::allocated_bytes();
+
+  for (std::size_t pos{}; pos < instances; ++pos) {
+    connect(signals.emplace_back(), listeners);
+  }
+
+  const auto scenario = "footprint_" + std::to_string(count);
+  escad::bench::report_footprint(
+      opts, engine, scenario, sizeof(Signal),
+      static_cast<double>(escad::bench::allocated_bytes() - bytes) / instances,
+      static_cast<double>(escad::bench::allocations() - allocs) / instances);
+}
+
+template <class Signal>
+void publish(const escad::bench::options &opts, std::string_view engine,
+             std::size_t count) {
+  std::vector<listener> listeners(count);
+  Signal signal;
+  connect(signal, listeners);
+
+  const auto scenario = "publish_" + std::to_string(count);
+  const auto res = escad::bench::run(engine, scenario, opts.events,
+                                     opts.events * count, [&](std::size_t n) {
+                                       for (std::size_t pos{}; pos < n; ++pos) {
+                                         signal.publish(static_cast<int>(pos));
+                                       }
+                                     });
+
+  escad::bench::do_not_optimize(listeners.front().sum);
+  escad::bench::report(opts, res);
+}
+
+// same work as publish, listener by listener over bursts of events
+template <class Signal>
+void publish_batch(const escad::bench::options &opts, std::string_view engine,
+                   std::size_t count) {
+  std::vector<listener> listeners(count);
+  std::vector<int> burst(batch_size);
+  Signal signal;
+  connect(signal, listeners);
+
+  for (std::size_t pos{}; pos < batch_size; ++pos) {
+    burst[pos] = static_cast<int>(pos);
+  }
+
+  const auto scenario = "publish_batch_" + std::to_string(count);
+  const auto res = escad::bench::run(
+      engine, scenario, opts.events, opts.events * count, [&](std::size_t n) {
+        for (std::size_t pos{}; pos < n; pos += batch_size) {
+          const auto last = burst.begin() + static_cast<std::ptrdiff_t>(
+                                                std::min(batch_size, n - pos));
+          signal.publish_batch(burst.begin(), last);
+        }
+      });
+
+  escad::bench::do_not_optimize(listeners.front().sum);
+  escad::bench::report(opts, res);
+}
+
+// one listener out of many released and connected again per event
+template <class Signal, bool Checked>
+void churn(const escad::bench::options &opts, std::string_view engine,
+           std::size_t count) {
+  std::vector<listener> listeners(count);
+  std::vector<escad::connection> conns(count);
+  Signal signal;
+  escad::slot slot{signal};
+
+  for (std::size_t pos{}; pos < count; ++pos) {
+    conns[pos] =
+        slot.template connect_unchecked<&listener::receive>(listeners[pos]);
+  }
+
+  const auto scenario = std::string{Checked ? "churn_" : "churn_unchecked_"} +
+                        std::to_string(count);
+  const auto res = escad::bench::run(
+      engine, scenario, opts.events, opts.events, [&](std::size_t n) {
+        for (std::size_t pos{}; pos < n; ++pos) {
+          auto &elem = listeners[pos % count];
+          auto &conn = conns[pos % count];
+          conn.release();
+
+          if constexpr (Checked) {
+            conn = slot.template connect<&listener::receive>(elem);
+          } else {
+            conn = slot.template connect_unchecked<&listener::receive>(elem);
+          }
+        }
+      });
+
+  escad::bench::do_not_optimize(signal.size());
+  escad::bench::report(opts, res);
+}
+
+template <class Signal>
+void run_all(const escad::bench::options &opts, std::string_view engine) {
+  for (std::size_t count : {1u, 3u, 8u}) {
+    footprint<Signal>(opts, engine, count);
+    publish<Signal>(opts, engine, count);
+    publish_batch<Signal>(opts, engine, count);
+  }
+
+  churn<Signal, true>(opts, engine, churn_size);
+  churn<Signal, false>(opts, engine, churn_size);
+}
+
+// same work as publish, with the listeners fixed at compile time
+template <std::size_t Count>
+void publish_static(const escad::bench::options &opts) {
+  const auto scenario = "publish_" + std::to_string(Count);
+  const auto res = escad::bench::run(
+      "static_signal", scenario, opts.events, opts.events * Count,
+      [](std::size_t n) {
+        for (std::size_t pos{}; pos < n; ++pos) {
+          static_signal_for<Count>::publish(static_cast<int>(pos));
+        }
+      });
+
+  escad::bench::do_not_optimize(static_sums[0u]);
+  escad::bench::report(opts, res);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const escad::bench::options opts{argc, argv};
+  run_all<escad::signal<void(int)>>(opts, "signal");
+  run_all<escad::small_signal<void(int), inline_size>>(opts, "small_signal_3");
+  publish_static<1u>(opts);
+  publish_static<3u>(opts);
+  publish_static<8u>(opts);
+  return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file scenarios.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Events and dispatch loops shared by all engines
+ * @version 0.1
+ * @date 2024-03-18
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "bench.h"
+
+namespace escad::bench::scenario {
+
+/*! @brief Number of states of the ring scenario. */
+inline constexpr std::size_t ring_size = 50u;
+
+/*! @brief Every eighth event of the unhandled scenario is handled. */
+inline constexpr std::size_t unhandled_ratio = 8u;
+
+/*! @brief Toggles between the two states of the ping-pong machine. */
+struct ping {};
+
+/*! @brief Moves the ring machine one state further. */
+struct next {};
+
+/*! @brief Toggles the two innermost states of the deep hierarchy. */
+struct toggle {};
+
+/*! @brief Not handled by any state. */
+struct noise {};
+
+/*! @brief Ping with a 1 KiB payload, read by the state entered. */
+struct heavy {
+  std::array<double, 128> samples;
+};
+
+/*! @brief Sink for values read from event payloads. */
+inline double payload_sink = 0.0;
+
+template <class Machine, class Event>
+void dispatch_n(Machine &machine, std::size_t count, const Event &event) {
+  for (std::size_t pos{}; pos < count; ++pos) {
+    machine.dispatch(event);
+  }
+  do_not_optimize(machine);
+}
+
+template <class Machine>
+void dispatch_mostly_unhandled(Machine &machine, std::size_t count) {
+  for (std::size_t pos{}; pos < count; ++pos) {
+    if (pos % unhandled_ratio == unhandled_ratio - 1u) {
+      machine.dispatch(ping{});
+    } else {
+      machine.dispatch(noise{});
+    }
+  }
+  do_not_optimize(machine);
+}
+
+/**
+ * @brief Runs all scenarios for one engine.
+ *
+ * Factory has to provide ping_pong(), ring(), deep() returning ready to use
+ * machines. The ping-pong machine is used for the unhandled and the heavy
+ * payload scenarios as well.
+ */
+template <class Factory>
+void run_all(const options &opts, std::string_view engine, Factory factory) {
+  const auto n = opts.events;
+
+  {
+    auto machine = factory.ping_pong();
+    report(opts, run(engine, "ping_pong", n, n, [&](std::size_t count) {
+             dispatch_n(*machine, count, ping{});
+           }));
+  }
+
+  {
+    auto machine = factory.ring();
+    report(opts, run(engine, "ring_50", n, n, [&](std::size_t count) {
+             dispatch_n(*machine, count, next{});
+           }));
+  }
+
+  {
+    auto machine = factory.deep();
+    report(opts, run(engine, "deep_5", n, n, [&](std::size_t count) {
+             dispatch_n(*machine, count, toggle{});
+           }));
+  }
+
+  {
+    auto machine = factory.ping_pong();
+    report(opts, run(engine, "mostly_unhandled", n, n / unhandled_ratio,
+                     [&](std::size_t count) {
+                       dispatch_mostly_unhandled(*machine, count);
+                     }));
+  }
+
+  {
+    auto machine = factory.ping_pong();
+    heavy event{};
+    event.samples.fill(1.0);
+    report(opts, run(engine, "heavy_payload", n, n, [&](std::size_t count) {
+             dispatch_n(*machine, count, event);
+           }));
+  }
+
+  do_not_optimize(payload_sink);
+}
+
+} // namespace escad::bench::scenario
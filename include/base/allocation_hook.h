@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "counting_allocator.h"
+
+namespace escad {
+
+/**
+ * @brief Returns the statistics of the global allocation functions for the
+ * calling thread.
+ *
+ * The global operator new and operator delete are only replaced in programs
+ * in which exactly one translation unit defines
+ * `FSM_ALLOCATION_HOOK_IMPLEMENTATION` before including this file. Using this
+ * function in any other program results in a linker error.
+ *
+ * @return The allocation statistics of the calling thread.
+ */
+[[nodiscard]] allocation_stats &thread_allocation_stats() noexcept;
+
+/**
+ * @brief Counts the global allocations of the calling thread within a scope.
+ *
+ * @code{.cpp}
+ * escad::allocation_scope scope{};
+ * machine.dispatch(event);
+ * assert(scope.allocations() == 0u);
+ * @endcode
+ */
+class allocation_scope {
+public:
+    /*! @brief Starts counting. */
+    allocation_scope() noexcept
+        : start{thread_allocation_stats()} {}
+
+    /**
+     * @brief Returns the number of allocations since construction.
+     * @return The number of allocations since construction.
+     */
+    [[nodiscard]] std::size_t allocations() const noexcept {
+        return thread_allocation_stats().allocations - start.allocations;
+    }
+
+    /**
+     * @brief Returns the number of deallocations since construction.
+     * @return The number of deallocations since construction.
+     */
+    [[nodiscard]] std::size_t deallocations() const noexcept {
+        return thread_allocation_stats().deallocations - start.deallocations;
+    }
+
+    /**
+     * @brief Returns the number of bytes allocated since construction.
+     * @return The number of bytes allocated since construction.
+     */
+    [[nodiscard]] std::size_t bytes() const noexcept {
+        return thread_allocation_stats().bytes - start.bytes;
+    }
+
+private:
+    allocation_stats start;
+};
+
+} // namespace escad
+
+#if defined FSM_ALLOCATION_HOOK_IMPLEMENTATION
+
+namespace escad {
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+inline void *hooked_allocate(std::size_t size) {
+    auto &stats = thread_allocation_stats();
+    ++stats.allocations;
+    stats.bytes += size;
+
+    if(void *ptr = std::malloc(size ? size : 1u)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+inline void *hooked_allocate(std::size_t size, std::align_val_t align) {
+    auto &stats = thread_allocation_stats();
+    ++stats.allocations;
+    stats.bytes += size;
+
+    const auto alignment = static_cast<std::size_t>(align);
+    const auto rounded = (size + alignment - 1u) / alignment * alignment;
+
+    if(void *ptr = std::aligned_alloc(alignment, rounded ? rounded : alignment)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc{};
+}
+
+inline void hooked_deallocate(void *ptr) noexcept {
+    if(ptr) {
+        ++thread_allocation_stats().deallocations;
+        std::free(ptr);
+    }
+}
+
+} // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+allocation_stats &thread_allocation_stats() noexcept {
+    thread_local allocation_stats stats{};
+    return stats;
+}
+
+} // namespace escad
+
+void *operator new(std::size_t size) {
+    return escad::details::hooked_allocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return escad::details::hooked_allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    return escad::details::hooked_allocate(size, align);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+    return escad::details::hooked_allocate(size, align);
+}
+
+void operator delete(void *ptr) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    escad::details::hooked_deallocate(ptr);
+}
+
+#endif
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace escad {
+
+/*! @brief Allocation statistics. */
+struct allocation_stats {
+    /*! @brief Number of allocations. */
+    std::size_t allocations{};
+    /*! @brief Number of deallocations. */
+    std::size_t deallocations{};
+    /*! @brief Number of bytes allocated so far. */
+    std::size_t bytes{};
+
+    /**
+     * @brief Returns the number of live allocations.
+     * @return The number of allocations not deallocated yet.
+     */
+    [[nodiscard]] constexpr std::size_t live() const noexcept {
+        return allocations - deallocations;
+    }
+
+    /*! @brief Resets all the counters. */
+    constexpr void reset() noexcept {
+        allocations = deallocations = bytes = 0u;
+    }
+};
+
+/**
+ * @brief Allocator that counts what it allocates.
+ *
+ * It can be used wherever an `Allocator` template parameter is accepted, such
+ * as for signals, dispatchers, emitters and dense maps. All the rebound copies
+ * of an allocator share the same statistics object, that isn't owned by the
+ * allocator and must outlive it.<br/>
+ * A default constructed allocator doesn't count anything.
+ *
+ * @tparam Type Type of elements to allocate.
+ * @tparam Allocator Type of the underlying allocator.
+ */
+template<typename Type, typename Allocator = std::allocator<Type>>
+class counting_allocator {
+    template<typename, typename>
+    friend class counting_allocator;
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+public:
+    /*! @brief Type of elements to allocate. */
+    using value_type = Type;
+    /*! @brief Pointer type. */
+    using pointer = value_type *;
+    /*! @brief Unsigned integer type. */
+    using size_type = std::size_t;
+    /*! @brief Rebinds both the allocator and the underlying allocator. */
+    template<typename Other>
+    struct rebind {
+        /*! @brief Rebound allocator type. */
+        using other = counting_allocator<Other, typename alloc_traits::template rebind_alloc<Other>>;
+    };
+
+    /*! @brief Default constructor, allocations aren't counted. */
+    constexpr counting_allocator() noexcept(std::is_nothrow_default_constructible_v<Allocator>)
+        : counting_allocator{nullptr} {}
+
+    /**
+     * @brief Constructs an allocator that counts into the given statistics.
+     * @param stats Statistics to update, if any.
+     * @param allocator The underlying allocator.
+     */
+    constexpr counting_allocator(allocation_stats *stats, const Allocator &allocator = Allocator{}) noexcept
+        : alloc{allocator},
+          counters{stats} {}
+
+    /**
+     * @brief Converting constructor.
+     * @tparam Other Type of elements of the other allocator.
+     * @tparam OtherAllocator Underlying allocator of the other allocator.
+     * @param other The allocator to copy from.
+     */
+    template<typename Other, typename OtherAllocator>
+    constexpr counting_allocator(const counting_allocator<Other, OtherAllocator> &other) noexcept
+        : alloc{other.alloc},
+          counters{other.counters} {}
+
+    /**
+     * @brief Allocates storage for a number of elements.
+     * @param length Number of elements to allocate.
+     * @return A pointer to the allocated storage.
+     */
+    [[nodiscard]] pointer allocate(const size_type length) {
+        static_assert(!std::is_void_v<value_type>, "Invalid value type");
+
+        if(counters) {
+            ++counters->allocations;
+            counters->bytes += length * sizeof(value_type);
+        }
+
+        return alloc_traits::allocate(alloc, length);
+    }
+
+    /**
+     * @brief Deallocates storage obtained from allocate.
+     * @param mem A pointer to the storage to deallocate.
+     * @param length Number of elements of the storage.
+     */
+    void deallocate(pointer mem, const size_type length) noexcept {
+        if(counters) {
+            ++counters->deallocations;
+        }
+
+        alloc_traits::deallocate(alloc, mem, length);
+    }
+
+    /**
+     * @brief Returns the statistics updated by the allocator, if any.
+     * @return A pointer to the statistics, if any.
+     */
+    [[nodiscard]] constexpr allocation_stats *stats() const noexcept {
+        return counters;
+    }
+
+    /**
+     * @brief Compares two allocators.
+     * @tparam Other Type of elements of the other allocator.
+     * @tparam OtherAllocator Underlying allocator of the other allocator.
+     * @param other The allocator with which to compare.
+     * @return True if the two allocators share the same statistics.
+     */
+    template<typename Other, typename OtherAllocator>
+    [[nodiscard]] constexpr bool operator==(const counting_allocator<Other, OtherAllocator> &other) const noexcept {
+        return counters == other.counters;
+    }
+
+    /**
+     * @brief Compares two allocators.
+     * @tparam Other Type of elements of the other allocator.
+     * @tparam OtherAllocator Underlying allocator of the other allocator.
+     * @param other The allocator with which to compare.
+     * @return True if the two allocators don't share the same statistics.
+     */
+    template<typename Other, typename OtherAllocator>
+    [[nodiscard]] constexpr bool operator!=(const counting_allocator<Other, OtherAllocator> &other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    Allocator alloc;
+    allocation_stats *counters;
+};
+
+} // namespace escad
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string_view>
 #include <type_traits>
 #include <utility>
@@ -20,8 +21,8 @@ namespace details {
 
 struct type_index final {
     [[nodiscard]] static id_type next() noexcept {
-        static id_type value{}; // std::atomic<Type>
-        return value++;
+        static std::atomic<id_type> value{};
+        return value.fetch_add(1u, std::memory_order_relaxed);
     }
 };
 
@@ -2,10 +2,12 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -17,6 +19,11 @@
 #include "../base/type_traits.h"
 #include "forwards.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define FSM_DENSE_MAP_SSE2
+#endif
+
 namespace escad {
 
 /**
@@ -26,18 +33,18 @@ namespace escad {
 
 namespace details {
 
-template<typename Key, typename Type>
+template<typename Key, typename Type, typename Index = std::size_t>
 struct dense_map_node final {
     using value_type = std::pair<Key, Type>;
 
     template<typename... Args>
     dense_map_node(const std::size_t pos, Args &&...args)
-        : next{pos},
+        : next{static_cast<Index>(pos)},
           element{std::forward<Args>(args)...} {}
 
     template<typename Allocator, typename... Args>
     dense_map_node(std::allocator_arg_t, const Allocator &allocator, const std::size_t pos, Args &&...args)
-        : next{pos},
+        : next{static_cast<Index>(pos)},
           element{escad::make_obj_using_allocator<value_type>(allocator, std::forward<Args>(args)...)} {}
 
     template<typename Allocator>
@@ -50,10 +57,203 @@ struct dense_map_node final {
         : next{other.next},
           element{escad::make_obj_using_allocator<value_type>(allocator, std::move(other.element))} {}
 
-    std::size_t next;
+    Index next;
     value_type element;
 };
 
+// groups of control bytes of the open addressing layout, a full slot holds the
+// 7 low bits of the hash of its element, free slots are negative
+struct dense_map_group final {
+    static constexpr std::size_t width = 16u;
+    static constexpr std::int8_t empty = -128;
+    static constexpr std::int8_t deleted = -2;
+
+    // one bit per slot of the group with the given control byte
+    [[nodiscard]] static std::uint32_t match(const std::int8_t *control, const std::int8_t value) noexcept {
+#if defined(FSM_DENSE_MAP_SSE2)
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(control));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+        std::uint32_t mask{};
+
+        for(std::size_t pos{}; pos < width; ++pos) {
+            mask |= static_cast<std::uint32_t>(control[pos] == value) << pos;
+        }
+
+        return mask;
+#endif
+    }
+
+    // one bit per empty or deleted slot of the group
+    [[nodiscard]] static std::uint32_t match_free(const std::int8_t *control) noexcept {
+#if defined(FSM_DENSE_MAP_SSE2)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(control))));
+#else
+        std::uint32_t mask{};
+
+        for(std::size_t pos{}; pos < width; ++pos) {
+            mask |= static_cast<std::uint32_t>(control[pos] < 0) << pos;
+        }
+
+        return mask;
+#endif
+    }
+};
+
+// the previous buckets of an incremental rehash and the first of them not yet
+// moved, there is a rehash in progress as long as they aren't empty
+template<typename Container, bool = true>
+struct dense_map_migration final {
+    template<typename Allocator>
+    explicit dense_map_migration(const Allocator &allocator)
+        : buckets{allocator},
+          next{} {}
+
+    template<typename Allocator>
+    dense_map_migration(const dense_map_migration &other, const Allocator &allocator)
+        : buckets{other.buckets, allocator},
+          next{other.next} {}
+
+    template<typename Allocator>
+    dense_map_migration(dense_map_migration &&other, const Allocator &allocator)
+        : buckets{std::move(other.buckets), allocator},
+          next{other.next} {}
+
+    Container buckets;
+    std::size_t next;
+};
+
+template<typename Container>
+struct dense_map_migration<Container, false> final {
+    template<typename Allocator>
+    explicit dense_map_migration(const Allocator &) noexcept {}
+
+    template<typename Allocator>
+    dense_map_migration(const dense_map_migration &, const Allocator &) noexcept {}
+
+    template<typename Allocator>
+    dense_map_migration(dense_map_migration &&, const Allocator &) noexcept {}
+};
+
+// leaves trivial elements uninitialized when resizing, the buckets are
+// initialized by the container itself, all at once or a few at a time
+template<typename Allocator>
+class dense_map_buckets_allocator: public Allocator {
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+public:
+    template<typename Other>
+    struct rebind {
+        using other = dense_map_buckets_allocator<typename alloc_traits::template rebind_alloc<Other>>;
+    };
+
+    dense_map_buckets_allocator() = default;
+
+    template<typename Other>
+    dense_map_buckets_allocator(const Other &other) noexcept
+        : Allocator{other} {}
+
+    template<typename Type>
+    void construct(Type *ptr) noexcept(std::is_nothrow_default_constructible_v<Type>) {
+        ::new(static_cast<void *>(ptr)) Type;
+    }
+
+    template<typename Type, typename... Args>
+    void construct(Type *ptr, Args &&...args) {
+        alloc_traits::construct(static_cast<Allocator &>(*this), ptr, std::forward<Args>(args)...);
+    }
+};
+
+// a group of slots of the open addressing layout, the positions of the
+// elements follow the control bytes, so that a match is resolved from the
+// lines the probe has already loaded rather than from a separate array
+template<typename Index>
+struct dense_map_slots final {
+    std::int8_t bytes[dense_map_group::width];
+    Index index[dense_map_group::width];
+};
+
+// chained buckets have no control bytes at all
+template<typename Allocator, typename Index, bool = true>
+struct dense_map_control final {
+    using slots_type = dense_map_slots<Index>;
+    using container_type = std::vector<slots_type, dense_map_buckets_allocator<typename std::allocator_traits<Allocator>::template rebind_alloc<slots_type>>>;
+
+    explicit dense_map_control(const Allocator &allocator)
+        : groups{allocator},
+          tombstones{} {}
+
+    dense_map_control(const dense_map_control &other, const Allocator &allocator)
+        : groups{other.groups, allocator},
+          tombstones{other.tombstones} {}
+
+    dense_map_control(dense_map_control &&other, const Allocator &allocator)
+        : groups{std::move(other.groups), allocator},
+          tombstones{other.tombstones} {}
+
+    // all the slots are empty afterwards, the positions are left as they are
+    void assign(const std::size_t count) {
+        groups.resize(count);
+
+        for(auto &&group: groups) {
+            for(auto &&byte: group.bytes) {
+                byte = dense_map_group::empty;
+            }
+        }
+
+        tombstones = 0u;
+    }
+
+    [[nodiscard]] std::int8_t &tag(const std::size_t slot) noexcept {
+        return groups[slot / dense_map_group::width].bytes[slot % dense_map_group::width];
+    }
+
+    [[nodiscard]] std::int8_t tag(const std::size_t slot) const noexcept {
+        return groups[slot / dense_map_group::width].bytes[slot % dense_map_group::width];
+    }
+
+    [[nodiscard]] Index &index(const std::size_t slot) noexcept {
+        return groups[slot / dense_map_group::width].index[slot % dense_map_group::width];
+    }
+
+    [[nodiscard]] Index index(const std::size_t slot) const noexcept {
+        return groups[slot / dense_map_group::width].index[slot % dense_map_group::width];
+    }
+
+    container_type groups;
+    std::size_t tombstones;
+};
+
+template<typename Allocator, typename Index>
+struct dense_map_control<Allocator, Index, false> final {
+    explicit dense_map_control(const Allocator &) noexcept {}
+    dense_map_control(const dense_map_control &, const Allocator &) noexcept {}
+    dense_map_control(dense_map_control &&, const Allocator &) noexcept {}
+};
+
+[[nodiscard]] inline std::size_t lowest_bit(std::uint32_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctz(mask));
+#else
+    std::size_t pos{};
+
+    for(; !(mask & 1u); mask >>= 1u) {
+        ++pos;
+    }
+
+    return pos;
+#endif
+}
+
+// a hint only, a no-op where unsupported
+inline void prefetch([[maybe_unused]] const void *addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr);
+#elif defined(FSM_DENSE_MAP_SSE2)
+    _mm_prefetch(static_cast<const char *>(addr), _MM_HINT_T0);
+#endif
+}
+
 template<typename It>
 class dense_map_iterator final {
     template<typename>
@@ -182,6 +382,7 @@ class dense_map_local_iterator final {
 
     using first_type = decltype(std::as_const(std::declval<It>()->element.first));
     using second_type = decltype((std::declval<It>()->element.second));
+    using index_type = decltype(std::declval<It>()->next);
 
 public:
     using value_type = std::pair<first_type, second_type>;
@@ -196,7 +397,7 @@ public:
 
     constexpr dense_map_local_iterator(It iter, const std::size_t pos) noexcept
         : it{iter},
-          offset{pos} {}
+          offset{static_cast<index_type>(pos)} {}
 
     template<typename Other, typename = std::enable_if_t<!std::is_same_v<It, Other> && std::is_constructible_v<It, Other>>>
     constexpr dense_map_local_iterator(const dense_map_local_iterator<Other> &other) noexcept
@@ -226,7 +427,7 @@ public:
 
 private:
     It it;
-    std::size_t offset;
+    index_type offset;
 };
 
 template<typename ILhs, typename IRhs>
@@ -253,95 +454,388 @@ template<typename ILhs, typename IRhs>
  * placed into depends entirely on the hash of its key. Keys with the same hash
  * code appear in the same bucket.
  *
+ * Elements are always stored in a packed array, the layout of the index on
+ * top of it is selected by template parameter:
+ *
+ * * `chained_buckets`, the default: every bucket is a chain of elements linked
+ *   through the packed array.
+ * * `control_bytes`: open addressing over groups of 16 slots, each with a
+ *   control byte holding 7 bits of the hash of its element. A group is probed
+ *   at once, with SSE2 where available, and an element is only compared when
+ *   its control byte matches. The positions of the elements are stored within
+ *   the groups, right after the control bytes. Every bucket is a single slot,
+ *   the maximum load factor must be less than 1.
+ * * `incremental_buckets`: chained buckets, except that growing doesn't
+ *   rebuild the index at once. The previous buckets are kept and moved a few
+ *   at a time by the following insertions, lookups check either array
+ *   depending on how far the move went. While a move is in progress, the
+ *   bucket interface sees the buckets not yet moved as empty, an explicit
+ *   rehash completes the move.
+ *
+ * Positions of elements within the packed array are stored as `Index`, both
+ * by the buckets and by the links of the chains. A narrower type, e.g.
+ * `std::uint32_t`, saves memory and packs more of the index into a cache line,
+ * at the price of a smaller maximum size.
+ *
  * @tparam Key Key type of the associative container.
  * @tparam Type Mapped type of the associative container.
  * @tparam Hash Type of function to use to hash the keys.
  * @tparam KeyEqual Type of function to use to compare the keys for equality.
  * @tparam Allocator Type of allocator used to manage memory and elements.
+ * @tparam Layout Layout of the index, `chained_buckets`, `control_bytes` or
+ * `incremental_buckets`.
+ * @tparam Index Unsigned integer type of the positions stored by the index.
  */
-template<typename Key, typename Type, typename Hash, typename KeyEqual, typename Allocator>
+template<typename Key, typename Type, typename Hash, typename KeyEqual, typename Allocator, typename Layout, typename Index>
 class dense_map {
     static constexpr float default_threshold = 0.875f;
     static constexpr std::size_t minimum_capacity = 8u;
-
-    using node_type = details::dense_map_node<Key, Type>;
+    // previous buckets moved per insertion, twice as many as needed to finish
+    // before the next rehash is due, erasures don't move any
+    static constexpr std::size_t migration_step = 4u;
+    static constexpr bool open_addressing = std::is_same_v<Layout, control_bytes>;
+    static constexpr bool incremental = std::is_same_v<Layout, incremental_buckets>;
+    static_assert(open_addressing || incremental || std::is_same_v<Layout, chained_buckets>, "Invalid layout");
+    static_assert(std::is_unsigned_v<Index> && !std::is_same_v<Index, bool>, "Invalid index type");
+
+    using node_type = details::dense_map_node<Key, Type, Index>;
+    using group_type = details::dense_map_group;
+    using control_type = details::dense_map_control<Allocator, Index, open_addressing>;
     using alloc_traits = typename std::allocator_traits<Allocator>;
     static_assert(std::is_same_v<typename alloc_traits::value_type, std::pair<const Key, Type>>, "Invalid value type");
-    using sparse_container_type = std::vector<std::size_t, typename alloc_traits::template rebind_alloc<std::size_t>>;
+    using sparse_container_type = std::vector<Index, details::dense_map_buckets_allocator<typename alloc_traits::template rebind_alloc<Index>>>;
     using packed_container_type = std::vector<node_type, typename alloc_traits::template rebind_alloc<node_type>>;
+    using migration_type = details::dense_map_migration<sparse_container_type, incremental>;
+
+    static constexpr std::size_t null = (std::numeric_limits<std::size_t>::max)();
+    // end of a chain, as stored by the index
+    static constexpr Index none = (std::numeric_limits<Index>::max)();
+
+    [[nodiscard]] std::size_t hash_to_bucket(const std::size_t hash) const noexcept {
+        return escad::fast_mod(hash, bucket_count());
+    }
 
     template<typename Other>
     [[nodiscard]] std::size_t key_to_bucket(const Other &key) const noexcept {
-        return escad::fast_mod(sparse.second()(key), bucket_count());
+        return hash_to_bucket(sparse.second()(key));
+    }
+
+    // first link of the chain of a hash, within the previous buckets if they
+    // haven't been moved yet
+    [[nodiscard]] const Index &head(const std::size_t hash) const noexcept {
+        if constexpr(incremental) {
+            if(!migration.buckets.empty()) {
+                if(const auto bucket = escad::fast_mod(hash, migration.buckets.size()); bucket >= migration.next) {
+                    return migration.buckets[bucket];
+                }
+            }
+        }
+
+        return sparse.first()[hash_to_bucket(hash)];
+    }
+
+    [[nodiscard]] Index &head(const std::size_t hash) noexcept {
+        return const_cast<Index &>(std::as_const(*this).head(hash));
+    }
+
+    // spreads sequential hashes, e.g. from an identity, over groups and tags
+    [[nodiscard]] static std::size_t hash_to_probe(const std::size_t hash) noexcept {
+        constexpr auto golden = sizeof(std::size_t) == 8u ? static_cast<std::size_t>(0x9E3779B97F4A7C15ull) : static_cast<std::size_t>(0x9E3779B9u);
+        const auto value = hash * golden;
+        return value ^ (value >> (std::numeric_limits<std::size_t>::digits / 2));
     }
 
     template<typename Other>
-    [[nodiscard]] auto constrained_find(const Other &key, std::size_t bucket) {
-        for(auto it = begin(bucket), last = end(bucket); it != last; ++it) {
-            if(packed.second()(it->first, key)) {
-                return begin() + static_cast<typename iterator::difference_type>(it.index());
+    [[nodiscard]] std::size_t key_to_hash(const Other &key) const noexcept {
+        return hash_to_probe(sparse.second()(key));
+    }
+
+    // first group of the probe sequence of a hash
+    [[nodiscard]] std::size_t hash_to_group(const std::size_t hash) const noexcept {
+        return (hash >> 7u) & (control.groups.size() - 1u);
+    }
+
+    [[nodiscard]] static std::int8_t hash_to_tag(const std::size_t hash) noexcept {
+        return static_cast<std::int8_t>(hash & 0x7Fu);
+    }
+
+    // visits the groups of the probe sequence of a hash until one with empty
+    // slots, returns the first matching slot, if any
+    template<typename Func>
+    [[nodiscard]] std::size_t probe(const std::size_t hash, Func func) const {
+        const auto tag = hash_to_tag(hash);
+        const auto mask = control.groups.size() - 1u;
+
+        for(std::size_t pos = hash_to_group(hash), step{};; pos = (pos + ++step) & mask) {
+            const auto &group = control.groups[pos];
+
+            for(auto match = group_type::match(group.bytes, tag); match; match &= match - 1u) {
+                if(const auto slot = details::lowest_bit(match); func(group.index[slot])) {
+                    return pos * group_type::width + slot;
+                }
+            }
+
+            if(group_type::match(group.bytes, group_type::empty)) {
+                return null;
             }
         }
+    }
+
+    // first empty or deleted slot of the probe sequence of a hash
+    [[nodiscard]] std::size_t probe_free(const std::size_t hash) const noexcept {
+        const auto mask = control.groups.size() - 1u;
+        auto pos = hash_to_group(hash);
+
+        for(std::size_t step{}; !group_type::match_free(control.groups[pos].bytes); pos = (pos + ++step) & mask) {}
 
-        return end();
+        return pos * group_type::width + details::lowest_bit(group_type::match_free(control.groups[pos].bytes));
+    }
+
+    template<typename Other>
+    [[nodiscard]] std::size_t probe_key(const Other &key, const std::size_t hash) const {
+        return probe(hash, [this, &key](const std::size_t index) { return packed.second()(packed.first()[index].element.first, key); });
+    }
+
+    // position of the element in a slot, null for free slots
+    [[nodiscard]] std::size_t slot_to_index(const std::size_t slot) const noexcept {
+        return (slot == null || control.tag(slot) < 0) ? null : control.index(slot);
+    }
+
+    // the element at the given position takes a free slot
+    void link(const std::size_t hash, const std::size_t index) noexcept {
+        const auto slot = probe_free(hash);
+        control.tombstones -= (control.tag(slot) == group_type::deleted);
+        control.tag(slot) = hash_to_tag(hash);
+        control.index(slot) = static_cast<Index>(index);
+    }
+
+    // position of the element with the given key and hash, null if missing
+    template<typename Other>
+    [[nodiscard]] std::size_t index_of(const Other &key, const std::size_t hash) const {
+        if constexpr(open_addressing) {
+            // the position comes with the match, the slot isn't needed
+            std::size_t found = null;
+
+            static_cast<void>(probe(hash_to_probe(hash), [this, &key, &found](const std::size_t index) {
+                return packed.second()(packed.first()[index].element.first, key) && ((found = index), true);
+            }));
+
+            return found;
+        } else {
+            auto pos = head(hash);
+            for(; pos != none && !packed.second()(packed.first()[pos].element.first, key); pos = packed.first()[pos].next) {}
+            return pos == none ? null : pos;
+        }
     }
 
     template<typename Other>
-    [[nodiscard]] auto constrained_find(const Other &key, std::size_t bucket) const {
-        for(auto it = cbegin(bucket), last = cend(bucket); it != last; ++it) {
-            if(packed.second()(it->first, key)) {
-                return cbegin() + static_cast<typename iterator::difference_type>(it.index());
+    [[nodiscard]] auto lookup(const Other &key, const std::size_t hash) {
+        const auto index = index_of(key, hash);
+        return index == null ? end() : begin() + static_cast<typename iterator::difference_type>(index);
+    }
+
+    template<typename Other>
+    [[nodiscard]] auto lookup(const Other &key, const std::size_t hash) const {
+        const auto index = index_of(key, hash);
+        return index == null ? cend() : cbegin() + static_cast<typename iterator::difference_type>(index);
+    }
+
+    // stages the lookups of a chunk of keys, so that the loads of a stage are
+    // in flight at once, then calls the function with the position of every
+    // element in order, null if missing
+    template<typename It, typename Func>
+    void lookup_batch(It first, It last, Func func) const {
+        constexpr std::size_t chunk = 16u;
+        std::size_t hash[chunk];
+        std::size_t candidate[chunk];
+
+        while(first != last) {
+            std::size_t count{};
+
+            for(auto it = first; count < chunk && it != last; ++it, ++count) {
+                hash[count] = sparse.second()(*it);
+
+                if constexpr(open_addressing) {
+                    details::prefetch(control.groups.data() + hash_to_group(hash_to_probe(hash[count])));
+                } else {
+                    details::prefetch(&head(hash[count]));
+                }
+            }
+
+            for(std::size_t pos{}; pos < count; ++pos) {
+                if constexpr(open_addressing) {
+                    const auto probe = hash_to_probe(hash[pos]);
+                    const auto &group = control.groups[hash_to_group(probe)];
+                    const auto match = group_type::match(group.bytes, hash_to_tag(probe));
+                    candidate[pos] = match ? group.index[details::lowest_bit(match)] : null;
+                } else {
+                    const auto first = head(hash[pos]);
+                    candidate[pos] = first == none ? null : first;
+                }
+
+                if(candidate[pos] != null) {
+                    details::prefetch(packed.first().data() + candidate[pos]);
+                }
+            }
+
+            for(std::size_t pos{}; pos < count; ++pos, ++first) {
+                func(index_of(*first, hash[pos]));
             }
         }
+    }
 
-        return cend();
+    // positions past the largest index can't be linked
+    void check_room() const {
+        if(size() >= max_size()) {
+            throw std::length_error{"dense_map: index overflow"};
+        }
     }
 
     template<typename Other, typename... Args>
     [[nodiscard]] auto insert_or_do_nothing(Other &&key, Args &&...args) {
-        const auto index = key_to_bucket(key);
+        const auto hash = static_cast<std::size_t>(sparse.second()(key));
+        return insert_hashed_or_do_nothing(hash, std::forward<Other>(key), std::forward<Args>(args)...);
+    }
+
+    template<typename Other, typename... Args>
+    [[nodiscard]] auto insert_hashed_or_do_nothing(const std::size_t hash, Other &&key, Args &&...args) {
+        if constexpr(open_addressing) {
+            const auto probe = hash_to_probe(hash);
+
+            if(const auto slot = probe_key(key, probe); slot != null) {
+                return std::make_pair(begin() + static_cast<typename iterator::difference_type>(slot_to_index(slot)), false);
+            }
 
-        if(auto it = constrained_find(key, index); it != end()) {
-            return std::make_pair(it, false);
+            check_room();
+            packed.first().emplace_back(null, std::piecewise_construct, std::forward_as_tuple(std::forward<Other>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+            link(probe, packed.first().size() - 1u);
+        } else {
+            if(const auto index = index_of(key, hash); index != null) {
+                return std::make_pair(begin() + static_cast<typename iterator::difference_type>(index), false);
+            }
+
+            check_room();
+            auto &first = head(hash);
+            packed.first().emplace_back(first, std::piecewise_construct, std::forward_as_tuple(std::forward<Other>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+            first = static_cast<Index>(packed.first().size() - 1u);
         }
 
-        packed.first().emplace_back(sparse.first()[index], std::piecewise_construct, std::forward_as_tuple(std::forward<Other>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
-        sparse.first()[index] = packed.first().size() - 1u;
         rehash_if_required();
-
         return std::make_pair(--end(), true);
     }
 
     template<typename Other, typename Arg>
     [[nodiscard]] auto insert_or_overwrite(Other &&key, Arg &&value) {
-        const auto index = key_to_bucket(key);
+        if constexpr(open_addressing) {
+            const auto hash = key_to_hash(key);
+
+            if(const auto slot = probe_key(key, hash); slot != null) {
+                auto it = begin() + static_cast<typename iterator::difference_type>(slot_to_index(slot));
+                it->second = std::forward<Arg>(value);
+                return std::make_pair(it, false);
+            }
 
-        if(auto it = constrained_find(key, index); it != end()) {
-            it->second = std::forward<Arg>(value);
-            return std::make_pair(it, false);
+            check_room();
+            packed.first().emplace_back(null, std::forward<Other>(key), std::forward<Arg>(value));
+            link(hash, packed.first().size() - 1u);
+        } else {
+            const auto hash = static_cast<std::size_t>(sparse.second()(key));
+
+            if(const auto index = index_of(key, hash); index != null) {
+                auto it = begin() + static_cast<typename iterator::difference_type>(index);
+                it->second = std::forward<Arg>(value);
+                return std::make_pair(it, false);
+            }
+
+            check_room();
+            auto &first = head(hash);
+            packed.first().emplace_back(first, std::forward<Other>(key), std::forward<Arg>(value));
+            first = static_cast<Index>(packed.first().size() - 1u);
         }
 
-        packed.first().emplace_back(sparse.first()[index], std::forward<Other>(key), std::forward<Arg>(value));
-        sparse.first()[index] = packed.first().size() - 1u;
         rehash_if_required();
-
         return std::make_pair(--end(), true);
     }
 
     void move_and_pop(const std::size_t pos) {
         if(const auto last = size() - 1u; pos != last) {
-            size_type *curr = sparse.first().data() + key_to_bucket(packed.first().back().element.first);
-            packed.first()[pos] = std::move(packed.first().back());
-            for(; *curr != last; curr = &packed.first()[*curr].next) {}
-            *curr = pos;
+            if constexpr(open_addressing) {
+                const auto slot = probe(key_to_hash(packed.first().back().element.first), [last](const std::size_t index) { return index == last; });
+                control.index(slot) = static_cast<Index>(pos);
+                packed.first()[pos] = std::move(packed.first().back());
+            } else {
+                Index *curr = &head(sparse.second()(packed.first().back().element.first));
+                packed.first()[pos] = std::move(packed.first().back());
+                for(; *curr != last; curr = &packed.first()[*curr].next) {}
+                *curr = static_cast<Index>(pos);
+            }
         }
 
         packed.first().pop_back();
     }
 
     void rehash_if_required() {
-        if(size() > (bucket_count() * max_load_factor())) {
-            rehash(bucket_count() * 2u);
+        if constexpr(open_addressing) {
+            // deleted slots count as used until the next rehash, which drops them
+            if(const auto limit = bucket_count() * max_load_factor(); (size() + control.tombstones) > limit) {
+                rehash(size() > (limit / 2u) ? bucket_count() * 2u : bucket_count());
+            }
+        } else if constexpr(incremental) {
+            if(!migration.buckets.empty()) {
+                migrate(migration_step);
+            } else if(size() > (bucket_count() * max_load_factor())) {
+                // the current buckets become the previous ones, later calls
+                // move them a few at a time
+                migration.buckets.swap(sparse.first());
+                sparse.first().resize(migration.buckets.size() * 2u);
+                migrate(migration_step);
+            }
+        } else {
+            if(size() > (bucket_count() * max_load_factor())) {
+                rehash(bucket_count() * 2u);
+            }
+        }
+    }
+
+    // moves the chains of the given number of previous buckets, the current
+    // buckets they split into are initialized on the way
+    void migrate(const std::size_t count) {
+        auto &&buckets = migration.buckets;
+        const auto last = (buckets.size() - migration.next) > count ? (migration.next + count) : buckets.size();
+
+        for(; migration.next < last; ++migration.next) {
+            for(auto pos = migration.next; pos < bucket_count(); pos += buckets.size()) {
+                sparse.first()[pos] = none;
+            }
+
+            for(auto pos = buckets[migration.next]; pos != none;) {
+                auto &node = packed.first()[pos];
+                const auto next = node.next;
+                node.next = std::exchange(sparse.first()[key_to_bucket(node.element.first)], pos);
+                pos = next;
+            }
+        }
+
+        if(migration.next == buckets.size()) {
+            sparse_container_type{buckets.get_allocator()}.swap(buckets);
+            migration.next = 0u;
+        }
+    }
+
+    // first element of a bucket, the buckets an incremental rehash hasn't
+    // initialized yet look empty
+    [[nodiscard]] std::size_t bucket_to_index(const std::size_t bucket) const noexcept {
+        if constexpr(open_addressing) {
+            return slot_to_index(bucket);
+        } else {
+            if constexpr(incremental) {
+                if(!migration.buckets.empty() && escad::fast_mod(bucket, migration.buckets.size()) >= migration.next) {
+                    return null;
+                }
+            }
+
+            const auto first = sparse.first()[bucket];
+            return first == none ? null : first;
         }
     }
 
@@ -410,7 +904,9 @@ public:
     explicit dense_map(const size_type bucket_count, const hasher &hash = hasher{}, const key_equal &equal = key_equal{}, const allocator_type &allocator = allocator_type{})
         : sparse{allocator, hash},
           packed{allocator, equal},
-          threshold{default_threshold} {
+          threshold{default_threshold},
+          control{allocator},
+          migration{allocator} {
         rehash(bucket_count);
     }
 
@@ -425,7 +921,9 @@ public:
     dense_map(const dense_map &other, const allocator_type &allocator)
         : sparse{std::piecewise_construct, std::forward_as_tuple(other.sparse.first(), allocator), std::forward_as_tuple(other.sparse.second())},
           packed{std::piecewise_construct, std::forward_as_tuple(other.packed.first(), allocator), std::forward_as_tuple(other.packed.second())},
-          threshold{other.threshold} {}
+          threshold{other.threshold},
+          control{other.control, allocator},
+          migration{other.migration, allocator} {}
 
     /*! @brief Default move constructor. */
     dense_map(dense_map &&) noexcept(std::is_nothrow_move_constructible_v<escad::compressed_pair<sparse_container_type, hasher>> &&std::is_nothrow_move_constructible_v<escad::compressed_pair<packed_container_type, key_equal>>) = default;
@@ -438,7 +936,9 @@ public:
     dense_map(dense_map &&other, const allocator_type &allocator)
         : sparse{std::piecewise_construct, std::forward_as_tuple(std::move(other.sparse.first()), allocator), std::forward_as_tuple(std::move(other.sparse.second()))},
           packed{std::piecewise_construct, std::forward_as_tuple(std::move(other.packed.first()), allocator), std::forward_as_tuple(std::move(other.packed.second()))},
-          threshold{other.threshold} {}
+          threshold{other.threshold},
+          control{std::move(other.control), allocator},
+          migration{std::move(other.migration), allocator} {}
 
     /**
      * @brief Default copy assignment operator.
@@ -527,11 +1027,15 @@ public:
      * @return Maximum possible number of elements.
      */
     [[nodiscard]] size_type max_size() const noexcept {
-        return packed.first().max_size();
+        // the largest position is reserved for the end of chains
+        const auto limit = static_cast<size_type>(none);
+        return packed.first().max_size() < limit ? packed.first().max_size() : limit;
     }
 
     /*! @brief Clears the container. */
     void clear() noexcept {
+        migration = migration_type{get_allocator()};
+        control = control_type{get_allocator()};
         sparse.first().clear();
         packed.first().clear();
         rehash(0u);
@@ -576,6 +1080,30 @@ public:
         }
     }
 
+    /**
+     * @brief Inserts an element with a precomputed hash into the container,
+     * if the key does not exist.
+     *
+     * The hash must be the one returned by the hash function of the container
+     * for the key of the element.
+     *
+     * @param value A key-value pair.
+     * @param hash Hash of the key.
+     * @return A pair consisting of an iterator to the inserted element (or to
+     * the element that prevented the insertion) and a bool denoting whether the
+     * insertion took place.
+     */
+    std::pair<iterator, bool> insert_hashed(const value_type &value, const size_type hash) {
+        FSM_ASSERT(hash == static_cast<size_type>(sparse.second()(value.first)), "Invalid hash");
+        return insert_hashed_or_do_nothing(hash, value.first, value.second);
+    }
+
+    /*! @copydoc insert_hashed */
+    std::pair<iterator, bool> insert_hashed(value_type &&value, const size_type hash) {
+        FSM_ASSERT(hash == static_cast<size_type>(sparse.second()(value.first)), "Invalid hash");
+        return insert_hashed_or_do_nothing(hash, std::move(value.first), std::move(value.second));
+    }
+
     /**
      * @brief Inserts an element into the container or assigns to the current
      * element if the key already exists.
@@ -617,16 +1145,31 @@ public:
             return insert_or_do_nothing(std::forward<Args>(args).first..., std::forward<Args>(args).second...);
         } else if constexpr(sizeof...(Args) == 2u) {
             return insert_or_do_nothing(std::forward<Args>(args)...);
+        } else if constexpr(open_addressing) {
+            check_room();
+            auto &node = packed.first().emplace_back(null, std::forward<Args>(args)...);
+            const auto hash = key_to_hash(node.element.first);
+
+            if(const auto slot = probe_key(node.element.first, hash); slot != null) {
+                packed.first().pop_back();
+                return std::make_pair(begin() + static_cast<typename iterator::difference_type>(slot_to_index(slot)), false);
+            }
+
+            link(hash, packed.first().size() - 1u);
+            rehash_if_required();
+
+            return std::make_pair(--end(), true);
         } else {
+            check_room();
             auto &node = packed.first().emplace_back(packed.first().size(), std::forward<Args>(args)...);
-            const auto index = key_to_bucket(node.element.first);
+            const auto hash = static_cast<std::size_t>(sparse.second()(node.element.first));
 
-            if(auto it = constrained_find(node.element.first, index); it != end()) {
+            if(const auto index = index_of(node.element.first, hash); index != null) {
                 packed.first().pop_back();
-                return std::make_pair(it, false);
+                return std::make_pair(begin() + static_cast<typename iterator::difference_type>(index), false);
             }
 
-            std::swap(node.next, sparse.first()[index]);
+            std::swap(node.next, head(hash));
             rehash_if_required();
 
             return std::make_pair(--end(), true);
@@ -688,13 +1231,30 @@ public:
      * @return Number of elements removed (either 0 or 1).
      */
     size_type erase(const key_type &key) {
-        for(size_type *curr = sparse.first().data() + key_to_bucket(key); *curr != (std::numeric_limits<size_type>::max)(); curr = &packed.first()[*curr].next) {
-            if(packed.second()(packed.first()[*curr].element.first, key)) {
-                const auto index = *curr;
-                *curr = packed.first()[*curr].next;
+        if constexpr(open_addressing) {
+            if(const auto slot = probe_key(key, key_to_hash(key)); slot != null) {
+                const auto index = control.index(slot);
+
+                // probes stop at groups with empty slots, no need for a tombstone
+                if(group_type::match(control.groups[slot / group_type::width].bytes, group_type::empty)) {
+                    control.tag(slot) = group_type::empty;
+                } else {
+                    control.tag(slot) = group_type::deleted;
+                    ++control.tombstones;
+                }
+
                 move_and_pop(index);
                 return 1u;
             }
+        } else {
+            for(Index *curr = &head(sparse.second()(key)); *curr != none; curr = &packed.first()[*curr].next) {
+                if(packed.second()(packed.first()[*curr].element.first, key)) {
+                    const auto index = *curr;
+                    *curr = packed.first()[*curr].next;
+                    move_and_pop(index);
+                    return 1u;
+                }
+            }
         }
 
         return 0u;
@@ -709,6 +1269,8 @@ public:
         swap(sparse, other.sparse);
         swap(packed, other.packed);
         swap(threshold, other.threshold);
+        swap(control, other.control);
+        swap(migration, other.migration);
     }
 
     /**
@@ -775,12 +1337,12 @@ public:
      * is found, a past-the-end iterator is returned.
      */
     [[nodiscard]] iterator find(const key_type &key) {
-        return constrained_find(key, key_to_bucket(key));
+        return lookup(key, sparse.second()(key));
     }
 
     /*! @copydoc find */
     [[nodiscard]] const_iterator find(const key_type &key) const {
-        return constrained_find(key, key_to_bucket(key));
+        return lookup(key, sparse.second()(key));
     }
 
     /**
@@ -794,14 +1356,92 @@ public:
     template<typename Other>
     [[nodiscard]] std::enable_if_t<mpl::is_transparent_v<hasher> && mpl::is_transparent_v<key_equal>, std::conditional_t<false, Other, iterator>>
     find(const Other &key) {
-        return constrained_find(key, key_to_bucket(key));
+        return lookup(key, sparse.second()(key));
     }
 
     /*! @copydoc find */
     template<typename Other>
     [[nodiscard]] std::enable_if_t<mpl::is_transparent_v<hasher> && mpl::is_transparent_v<key_equal>, std::conditional_t<false, Other, const_iterator>>
     find(const Other &key) const {
-        return constrained_find(key, key_to_bucket(key));
+        return lookup(key, sparse.second()(key));
+    }
+
+    /**
+     * @brief Finds an element with a given key and its precomputed hash.
+     *
+     * Same as find, for keys whose hash is already at hand, e.g. hashed
+     * strings. The hash must be the one returned by the hash function of the
+     * container for the key.
+     *
+     * @param key Key value of an element to search for.
+     * @param hash Hash of the key.
+     * @return An iterator to an element with the given key. If no such element
+     * is found, a past-the-end iterator is returned.
+     */
+    [[nodiscard]] iterator find_hashed(const key_type &key, const size_type hash) {
+        FSM_ASSERT(hash == static_cast<size_type>(sparse.second()(key)), "Invalid hash");
+        return lookup(key, hash);
+    }
+
+    /*! @copydoc find_hashed */
+    [[nodiscard]] const_iterator find_hashed(const key_type &key, const size_type hash) const {
+        FSM_ASSERT(hash == static_cast<size_type>(sparse.second()(key)), "Invalid hash");
+        return lookup(key, hash);
+    }
+
+    /**
+     * @brief Finds the elements with the given keys.
+     *
+     * Same as calling find for every key, in order. Keys are looked up a chunk
+     * at a time and the loads for the keys of a chunk are issued before any of
+     * them is resolved, which hides most of the latency of the lookups on
+     * tables that don't fit the caches.
+     *
+     * @tparam It Type of forward iterator.
+     * @tparam Out Type of output iterator.
+     * @param first An iterator to the first key of the range of keys.
+     * @param last An iterator past the last key of the range of keys.
+     * @param out An output iterator to which an iterator is written for every
+     * key, a past-the-end iterator if no such element is found.
+     * @return The output iterator past the last iterator written.
+     */
+    template<typename It, typename Out>
+    Out find_batch(It first, It last, Out out) {
+        lookup_batch(first, last, [this, &out](const size_type index) {
+            *out++ = (index == null) ? end() : begin() + static_cast<typename iterator::difference_type>(index);
+        });
+
+        return out;
+    }
+
+    /*! @copydoc find_batch */
+    template<typename It, typename Out>
+    Out find_batch(It first, It last, Out out) const {
+        lookup_batch(first, last, [this, &out](const size_type index) {
+            *out++ = (index == null) ? cend() : cbegin() + static_cast<typename const_iterator::difference_type>(index);
+        });
+
+        return out;
+    }
+
+    /**
+     * @brief Finds the elements with the given keys.
+     * @tparam Range Type of range of keys, e.g. a vector or an array.
+     * @tparam Out Type of output iterator.
+     * @param range A range of keys.
+     * @param out An output iterator to which an iterator is written for every
+     * key, a past-the-end iterator if no such element is found.
+     * @return The output iterator past the last iterator written.
+     */
+    template<typename Range, typename Out>
+    Out find_batch(const Range &range, Out out) {
+        return find_batch(std::begin(range), std::end(range), std::move(out));
+    }
+
+    /*! @copydoc find_batch */
+    template<typename Range, typename Out>
+    Out find_batch(const Range &range, Out out) const {
+        return find_batch(std::begin(range), std::end(range), std::move(out));
     }
 
     /**
@@ -872,7 +1512,7 @@ public:
      * @return An iterator to the beginning of the given bucket.
      */
     [[nodiscard]] const_local_iterator cbegin(const size_type index) const {
-        return {packed.first().begin(), sparse.first()[index]};
+        return {packed.first().begin(), bucket_to_index(index)};
     }
 
     /**
@@ -890,7 +1530,7 @@ public:
      * @return An iterator to the beginning of the given bucket.
      */
     [[nodiscard]] local_iterator begin(const size_type index) {
-        return {packed.first().begin(), sparse.first()[index]};
+        return {packed.first().begin(), bucket_to_index(index)};
     }
 
     /**
@@ -925,7 +1565,11 @@ public:
      * @return The number of buckets.
      */
     [[nodiscard]] size_type bucket_count() const {
-        return sparse.first().size();
+        if constexpr(open_addressing) {
+            return control.groups.size() * group_type::width;
+        } else {
+            return sparse.first().size();
+        }
     }
 
     /**
@@ -933,7 +1577,11 @@ public:
      * @return The maximum number of buckets.
      */
     [[nodiscard]] size_type max_bucket_count() const {
-        return sparse.first().max_size();
+        if constexpr(open_addressing) {
+            return control.groups.max_size() * group_type::width;
+        } else {
+            return sparse.first().max_size();
+        }
     }
 
     /**
@@ -947,11 +1595,21 @@ public:
 
     /**
      * @brief Returns the bucket for a given key.
+     *
+     * With the `control_bytes` layout, this is the slot of the key if it's
+     * in the container, the slot it would be inserted into otherwise.
+     *
      * @param key The value of the key to examine.
      * @return The bucket for the given key.
      */
     [[nodiscard]] size_type bucket(const key_type &key) const {
-        return key_to_bucket(key);
+        if constexpr(open_addressing) {
+            const auto hash = key_to_hash(key);
+            const auto slot = probe_key(key, hash);
+            return slot == null ? probe_free(hash) : slot;
+        } else {
+            return key_to_bucket(key);
+        }
     }
 
     /**
@@ -976,6 +1634,7 @@ public:
      */
     void max_load_factor(const float value) {
         FSM_ASSERT(value > 0.f, "Invalid load factor");
+        FSM_ASSERT(!open_addressing || value < 1.f, "Invalid load factor");
         threshold = value;
         rehash(0u);
     }
@@ -986,20 +1645,37 @@ public:
      * @param count New number of buckets.
      */
     void rehash(const size_type count) {
+        if constexpr(incremental) {
+            if(!migration.buckets.empty()) {
+                migrate(migration.buckets.size());
+            }
+        }
+
         auto value = count > minimum_capacity ? count : minimum_capacity;
         const auto cap = static_cast<size_type>(size() / max_load_factor());
         value = value > cap ? value : cap;
 
-        if(const auto sz = escad::next_power_of_two(value); sz != bucket_count()) {
+        if constexpr(open_addressing) {
+            const auto sz = escad::next_power_of_two(value > group_type::width ? value : group_type::width);
+
+            // a rehash to the same size drops the deleted slots
+            if(sz != bucket_count() || control.tombstones != 0u) {
+                control.assign(sz / group_type::width);
+
+                for(size_type pos{}, last = size(); pos < last; ++pos) {
+                    link(key_to_hash(packed.first()[pos].element.first), pos);
+                }
+            }
+        } else if(const auto sz = escad::next_power_of_two(value); sz != bucket_count()) {
             sparse.first().resize(sz);
 
             for(auto &&elem: sparse.first()) {
-                elem = std::numeric_limits<size_type>::max();
+                elem = none;
             }
 
             for(size_type pos{}, last = size(); pos < last; ++pos) {
                 const auto index = key_to_bucket(packed.first()[pos].element.first);
-                packed.first()[pos].next = std::exchange(sparse.first()[index], pos);
+                packed.first()[pos].next = std::exchange(sparse.first()[index], static_cast<Index>(pos));
             }
         }
     }
@@ -1010,6 +1686,10 @@ public:
      * @param count New number of elements.
      */
     void reserve(const size_type count) {
+        if(count > max_size()) {
+            throw std::length_error{"dense_map: index overflow"};
+        }
+
         packed.first().reserve(count);
         rehash(static_cast<size_type>(std::ceil(count / max_load_factor())));
     }
@@ -1034,6 +1714,8 @@ private:
     escad::compressed_pair<sparse_container_type, hasher> sparse;
     escad::compressed_pair<packed_container_type, key_equal> packed;
     float threshold;
+    control_type control;
+    migration_type migration;
 };
 
 } // namespace entt
@@ -1045,8 +1727,8 @@ private:
 
 namespace std {
 
-template<typename Key, typename Value, typename Allocator>
-struct uses_allocator<escad::details::dense_map_node<Key, Value>, Allocator>
+template<typename Key, typename Value, typename Index, typename Allocator>
+struct uses_allocator<escad::details::dense_map_node<Key, Value, Index>, Allocator>
     : std::true_type {};
 
 } // namespace std
@@ -1,16 +1,28 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 
 namespace escad {
 
+/*! @brief Index layout of dense_map, buckets chained through the elements. */
+struct chained_buckets {};
+
+/*! @brief Index layout of dense_map, open addressing over control bytes. */
+struct control_bytes {};
+
+/*! @brief Index layout of dense_map, chained buckets grown incrementally. */
+struct incremental_buckets {};
+
 template<
     typename Key,
     typename Type,
     typename = std::hash<Key>,
     typename = std::equal_to<Key>,
-    typename = std::allocator<std::pair<const Key, Type>>>
+    typename = std::allocator<std::pair<const Key, Type>>,
+    typename = chained_buckets,
+    typename = std::size_t>
 class dense_map;
 
 }
\ No newline at end of file
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "../base/assert.h"
+#include "../base/compressed_pair.h"
+
+namespace escad {
+
+/**
+ * @brief Vector with inline storage for a fixed number of elements.
+ *
+ * Up to `Size` elements are stored within the object itself, the allocator is
+ * used only when more elements are required. Once spilled, the elements stay
+ * on the heap until the vector is destroyed or moved from.<br/>
+ * The interface is a subset of the one of `std::vector`. Iterators are plain
+ * pointers and are invalidated by any operation that changes the size.
+ *
+ * @tparam Type Type of elements.
+ * @tparam Size Number of elements stored inline.
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template<typename Type, std::size_t Size, typename Allocator = std::allocator<Type>>
+class small_vector {
+    static_assert(Size != 0u, "Inline size must be greater than zero");
+    static_assert(std::is_nothrow_move_constructible_v<Type>, "Elements must be nothrow move constructible");
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename alloc_traits::value_type, Type>, "Invalid value type");
+
+public:
+    /*! @brief Allocator type. */
+    using allocator_type = Allocator;
+    /*! @brief Type of elements. */
+    using value_type = Type;
+    /*! @brief Unsigned integer type. */
+    using size_type = std::size_t;
+    /*! @brief Signed integer type. */
+    using difference_type = std::ptrdiff_t;
+    /*! @brief Reference type. */
+    using reference = value_type &;
+    /*! @brief Constant reference type. */
+    using const_reference = const value_type &;
+    /*! @brief Pointer type. */
+    using pointer = value_type *;
+    /*! @brief Constant pointer type. */
+    using const_pointer = const value_type *;
+    /*! @brief Random access iterator type. */
+    using iterator = pointer;
+    /*! @brief Constant random access iterator type. */
+    using const_iterator = const_pointer;
+
+    /*! @brief Default constructor. */
+    small_vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
+        : small_vector{allocator_type{}} {}
+
+    /**
+     * @brief Constructs an empty vector with a given allocator.
+     * @param allocator The allocator to use.
+     */
+    explicit small_vector(const allocator_type &allocator) noexcept
+        : storage{inline_data(), allocator},
+          length{},
+          reserved{Size} {}
+
+    /**
+     * @brief Copy constructor.
+     * @param other The instance to copy from.
+     */
+    small_vector(const small_vector &other)
+        : small_vector{other, alloc_traits::select_on_container_copy_construction(other.get_allocator())} {}
+
+    /**
+     * @brief Allocator-extended copy constructor.
+     * @param other The instance to copy from.
+     * @param allocator The allocator to use.
+     */
+    small_vector(const small_vector &other, const allocator_type &allocator)
+        : small_vector{allocator} {
+        reserve(other.length);
+        std::uninitialized_copy(other.begin(), other.end(), begin());
+        length = other.length;
+    }
+
+    /**
+     * @brief Move constructor.
+     * @param other The instance to move from.
+     */
+    small_vector(small_vector &&other) noexcept
+        : small_vector{other.get_allocator()} {
+        take(other);
+    }
+
+    /**
+     * @brief Allocator-extended move constructor.
+     * @param other The instance to move from.
+     * @param allocator The allocator to use.
+     */
+    small_vector(small_vector &&other, const allocator_type &allocator)
+        : small_vector{allocator} {
+        if(other.is_inline() || allocator == other.get_allocator()) {
+            take(other);
+        } else {
+            reserve(other.length);
+            std::uninitialized_move(other.begin(), other.end(), begin());
+            length = std::exchange(other.length, 0u);
+            std::destroy(other.begin(), other.begin() + length);
+        }
+    }
+
+    /*! @brief Default destructor. */
+    ~small_vector() {
+        clear();
+        release();
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other The instance to copy from.
+     * @return This vector.
+     */
+    small_vector &operator=(const small_vector &other) {
+        if(this != &other) {
+            small_vector copy{other, get_allocator()};
+            clear();
+            release();
+            take(copy);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other The instance to move from.
+     * @return This vector.
+     */
+    small_vector &operator=(small_vector &&other) noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if(this != &other) {
+            clear();
+
+            if constexpr(alloc_traits::propagate_on_container_move_assignment::value) {
+                release();
+                storage.second() = other.get_allocator();
+            }
+
+            if(other.is_inline() || get_allocator() == other.get_allocator()) {
+                release();
+                take(other);
+            } else {
+                reserve(other.length);
+                std::uninitialized_move(other.begin(), other.end(), begin());
+                length = other.length;
+                other.clear();
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Exchanges the contents with those of a given vector.
+     * @param other Vector to exchange the content with.
+     */
+    void swap(small_vector &other) {
+        small_vector tmp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    /**
+     * @brief Returns the associated allocator.
+     * @return The associated allocator.
+     */
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
+        return storage.second();
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning.
+     * @return An iterator to the first element of the vector.
+     */
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+        return storage.first();
+    }
+
+    /*! @copydoc cbegin */
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    /*! @copydoc begin */
+    [[nodiscard]] iterator begin() noexcept {
+        return storage.first();
+    }
+
+    /**
+     * @brief Returns an iterator to the end.
+     * @return An iterator to the element following the last one.
+     */
+    [[nodiscard]] const_iterator cend() const noexcept {
+        return storage.first() + length;
+    }
+
+    /*! @copydoc cend */
+    [[nodiscard]] const_iterator end() const noexcept {
+        return cend();
+    }
+
+    /*! @copydoc end */
+    [[nodiscard]] iterator end() noexcept {
+        return storage.first() + length;
+    }
+
+    /**
+     * @brief Checks whether a vector is empty.
+     * @return True if the vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return length == 0u;
+    }
+
+    /**
+     * @brief Returns the number of elements in a vector.
+     * @return Number of elements in a vector.
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        return length;
+    }
+
+    /**
+     * @brief Returns the number of elements that can be stored without
+     * allocating.
+     * @return Capacity of the vector.
+     */
+    [[nodiscard]] size_type capacity() const noexcept {
+        return reserved;
+    }
+
+    /**
+     * @brief Checks whether the elements are stored inline.
+     * @return True if no memory is allocated, false otherwise.
+     */
+    [[nodiscard]] bool is_inline() const noexcept {
+        return storage.first() == inline_data();
+    }
+
+    /**
+     * @brief Returns a pointer to the underlying array.
+     * @return A pointer to the underlying array.
+     */
+    [[nodiscard]] const_pointer data() const noexcept {
+        return storage.first();
+    }
+
+    /*! @copydoc data */
+    [[nodiscard]] pointer data() noexcept {
+        return storage.first();
+    }
+
+    /**
+     * @brief Returns the element at a given position.
+     * @param pos Position of the element to return.
+     * @return A reference to the requested element.
+     */
+    [[nodiscard]] const_reference operator[](const size_type pos) const noexcept {
+        FSM_ASSERT(pos < length, "Index out of bounds");
+        return storage.first()[pos];
+    }
+
+    /*! @copydoc operator[] */
+    [[nodiscard]] reference operator[](const size_type pos) noexcept {
+        FSM_ASSERT(pos < length, "Index out of bounds");
+        return storage.first()[pos];
+    }
+
+    /**
+     * @brief Increases the capacity of a vector.
+     * @param cap Desired capacity.
+     */
+    void reserve(const size_type cap) {
+        if(cap > reserved) {
+            auto &allocator = storage.second();
+            pointer mem = alloc_traits::allocate(allocator, cap);
+            std::uninitialized_move(begin(), end(), mem);
+            std::destroy(begin(), end());
+            release();
+            storage.first() = mem;
+            reserved = cap;
+        }
+    }
+
+    /*! @brief Clears a vector, the storage isn't released. */
+    void clear() noexcept {
+        std::destroy(begin(), end());
+        length = 0u;
+    }
+
+    /**
+     * @brief Constructs an element at the end of a vector.
+     * @tparam Args Types of arguments to use to construct the element.
+     * @param args Arguments to use to construct the element.
+     * @return A reference to the newly created element.
+     */
+    template<typename... Args>
+    reference emplace_back(Args &&...args) {
+        if(length == reserved) {
+            reserve(reserved * 2u);
+        }
+
+        pointer elem = storage.first() + length;
+        alloc_traits::construct(storage.second(), elem, std::forward<Args>(args)...);
+        ++length;
+        return *elem;
+    }
+
+    /**
+     * @brief Appends an element to a vector.
+     * @param value The element to append.
+     */
+    void push_back(const value_type &value) {
+        emplace_back(value);
+    }
+
+    /*! @copydoc push_back */
+    void push_back(value_type &&value) {
+        emplace_back(std::move(value));
+    }
+
+    /**
+     * @brief Inserts an element before a given position.
+     * @param pos An iterator to the element before which to insert.
+     * @param value The element to insert.
+     * @return An iterator to the inserted element.
+     */
+    iterator insert(const_iterator pos, value_type value) {
+        const auto offset = pos - cbegin();
+        emplace_back(std::move(value));
+        std::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    /**
+     * @brief Removes the elements in a given range.
+     * @param first An iterator to the first element of the range.
+     * @param last An iterator past the last element of the range.
+     * @return An iterator following the last removed element.
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto offset = first - cbegin();
+        const auto count = static_cast<size_type>(last - first);
+        iterator it = std::move(begin() + offset + count, end(), begin() + offset);
+        std::destroy(it, end());
+        length -= count;
+        return begin() + offset;
+    }
+
+    /**
+     * @brief Removes the element at a given position.
+     * @param pos An iterator to the element to remove.
+     * @return An iterator following the removed element.
+     */
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+private:
+    [[nodiscard]] pointer inline_data() noexcept {
+        return reinterpret_cast<pointer>(buffer);
+    }
+
+    [[nodiscard]] const_pointer inline_data() const noexcept {
+        return reinterpret_cast<const_pointer>(buffer);
+    }
+
+    // goes back to the inline storage
+    void release() noexcept {
+        if(!is_inline()) {
+            alloc_traits::deallocate(storage.second(), storage.first(), reserved);
+            storage.first() = inline_data();
+            reserved = Size;
+        }
+    }
+
+    // expects an empty vector that doesn't own any memory
+    void take(small_vector &other) noexcept {
+        if(other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), begin());
+            length = other.length;
+            other.clear();
+        } else {
+            storage.first() = std::exchange(other.storage.first(), other.inline_data());
+            reserved = std::exchange(other.reserved, Size);
+            length = std::exchange(other.length, 0u);
+        }
+    }
+
+    alignas(Type) unsigned char buffer[sizeof(Type) * Size];
+    compressed_pair<pointer, allocator_type> storage;
+    size_type length;
+    size_type reserved;
+};
+
+} // namespace escad
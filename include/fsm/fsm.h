@@ -11,11 +11,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
 #include "../signal/signal.h"
+#include "state_change.h"
 
 namespace escad {
 
@@ -191,6 +195,57 @@ struct has_handle<
 template <class T, class E>
 inline constexpr bool has_handle_v = has_handle<T, E>::value;
 
+/**
+ * @brief Per-state signal storage of a state variant.
+ *
+ * Primary template isn't defined on purpose, the state type of a fsm must be a
+ * std::variant.
+ *
+ * @tparam StateVariant The std::variant of all states.
+ */
+template <typename StateVariant> struct state_signals;
+
+/**
+ * @brief One signal per alternative, ordered like the alternatives of the
+ * variant. Each signal is typed on the state it belongs to.
+ *
+ * @tparam States The alternatives of the variant.
+ */
+template <typename... States> struct state_signals<std::variant<States...>> {
+  using type = std::tuple<escad::signal<void(const States &)>...>;
+};
+
+template <typename StateVariant>
+using state_signals_t = typename state_signals<StateVariant>::type;
+
+/**
+ * @brief Position of the first alternative of a variant which is State.
+ *
+ * Unlike std::get by type, the lookup is well-formed when the variant lists
+ * the same state more than once.
+ *
+ * @tparam State The state to look for.
+ * @tparam StateVariant The std::variant of all states.
+ */
+template <typename State, typename StateVariant> struct variant_index;
+
+template <typename State, typename... States>
+struct variant_index<State, std::variant<States...>> {
+  static constexpr std::size_t value = [] {
+    constexpr bool matches[]{std::is_same_v<State, States>...};
+    std::size_t pos{};
+    for (; pos < sizeof...(States) && !matches[pos]; ++pos) {
+    }
+    return pos;
+  }();
+
+  static_assert(value < sizeof...(States), "Unknown state");
+};
+
+template <typename State, typename StateVariant>
+inline constexpr std::size_t variant_index_v =
+    variant_index<State, StateVariant>::value;
+
 } // namespace details
 
 /**
@@ -210,10 +265,13 @@ public:
    * @brief Construct a new fsm object
    *
    */
-  fsm() : state_{}, NewStateSignal_{}, NewState{NewStateSignal_} {}
+  fsm()
+      : state_{}, NewStateSignal_{}, enterSignals_{}, exitSignals_{},
+        NewState{NewStateSignal_} {}
 
   fsm(const StateVariant &initial)
-      : state_{initial}, NewStateSignal_{}, NewState{NewStateSignal_} {}
+      : state_{initial}, NewStateSignal_{}, enterSignals_{}, exitSignals_{},
+        NewState{NewStateSignal_} {}
 
   /**
    * @brief Get the state object
@@ -244,6 +302,56 @@ public:
     return std::holds_alternative<State>(state_);
   }
 
+  /**
+   * @brief Slot to observe entering a specific state
+   *
+   * Listeners are only notified when State is entered, they get the new state
+   * itself instead of the whole StateVariant. A state listed more than once by
+   * the variant has a single slot.
+   *
+   * @tparam State
+   * @return escad::slot<escad::signal<void(const State &)>>
+   */
+  template <typename State> auto on_enter() {
+    return escad::slot{
+        std::get<details::variant_index_v<State, StateVariant>>(enterSignals_)};
+  }
+
+  /**
+   * @brief Slot to observe leaving a specific state
+   *
+   * Listeners are notified right before State is replaced by the new state.
+   *
+   * @tparam State
+   * @return escad::slot<escad::signal<void(const State &)>>
+   */
+  template <typename State> auto on_exit() {
+    return escad::slot{
+        std::get<details::variant_index_v<State, StateVariant>>(exitSignals_)};
+  }
+
+  /**
+   * @brief Enqueue state changes into a dispatcher
+   *
+   * Every transition enqueues a state_change record into the dispatcher, the
+   * observers connected to the state_change slot of the dispatcher are
+   * notified on its next update() instead of inside dispatch().
+   *
+   * @tparam Dispatcher escad::dispatcher or escad::concurrent_dispatcher
+   * @param dispatcher dispatcher to enqueue into, not owned
+   * @param machine id of this machine in the state_change records
+   */
+  template <typename Dispatcher>
+  void connect_changes(Dispatcher &dispatcher, escad::id_type machine) {
+    changes_.connect(dispatcher, machine);
+  }
+
+  /**
+   * @brief Stop enqueuing state changes
+   *
+   */
+  void disconnect_changes() { changes_.disconnect(); }
+
   /**
    * @brief dispatch an Event
    *
@@ -262,6 +370,8 @@ public:
         state_);
     // transition to new state
     if (new_state) {
+      const auto from = state_.index();
+      std::visit([&](auto &statePtr) { leave(statePtr); }, state_);
       state_ = *std::move(new_state);
 
       // call onEnter of the state if it exists, uses decltype SFINAE, see below
@@ -269,6 +379,8 @@ public:
       std::visit([&](auto &statePtr) { enter(statePtr, event); }, state_);
 
       // emit State Changed
+      changes_.enqueue(from, state_.index());
+      std::visit([&](auto &statePtr) { entered(statePtr); }, state_);
       NewStateSignal_.publish(state_);
     } else {
       auto new_state_internal = std::visit(
@@ -277,6 +389,8 @@ public:
           },
           state_);
       if (new_state_internal) {
+        const auto from = state_.index();
+        std::visit([&](auto &statePtr) { leave(statePtr); }, state_);
         state_ = *std::move(new_state_internal);
 
         // call onEnter of the state if it exists, uses decltype SFINAE, see
@@ -284,6 +398,8 @@ public:
         std::visit([&](auto &statePtr) { enter(statePtr, event); }, state_);
 
         // emit State Changed
+        changes_.enqueue(from, state_.index());
+        std::visit([&](auto &statePtr) { entered(statePtr); }, state_);
         NewStateSignal_.publish(state_);
       }
 
@@ -294,6 +410,9 @@ public:
 private:
   StateVariant state_;
   NewStateType NewStateSignal_;
+  details::state_signals_t<StateVariant> enterSignals_;
+  details::state_signals_t<StateVariant> exitSignals_;
+  escad::state_change_queue changes_;
 
 public:
   escad::slot<NewStateType> NewState;
@@ -312,6 +431,16 @@ private:
     }
   }
 
+  template <typename State> void entered(const State &state) {
+    std::get<details::variant_index_v<State, StateVariant>>(enterSignals_)
+        .publish(state);
+  }
+
+  template <typename State> void leave(const State &state) {
+    std::get<details::variant_index_v<State, StateVariant>>(exitSignals_)
+        .publish(state);
+  }
+
   template <typename State, typename Event>
   std::optional<StateVariant> handle(State &state, const Event &event) {
     if constexpr (details::has_handle_v<State, Event>) {
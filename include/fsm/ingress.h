@@ -0,0 +1,247 @@
+/**
+ * @file ingress.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Dispatch of wire messages into typed events by numeric id
+ * @version 0.1
+ * @date 2024-03-25
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../base/forwards.h"
+
+namespace escad {
+
+/**
+ * @brief Decoder for trivially copyable events.
+ *
+ * The payload must have exactly the size of the event, it is copied bytewise
+ * into the event.
+ *
+ * @tparam Event The event to decode.
+ */
+template <typename Event> struct trivial_decoder {
+  static_assert(std::is_trivially_copyable_v<Event>,
+                "Event must be trivially copyable");
+  static_assert(std::is_default_constructible_v<Event>,
+                "Event must be default constructible");
+
+  [[nodiscard]] std::optional<Event>
+  operator()(const std::byte *data, std::size_t size) const noexcept {
+    if (size != sizeof(Event)) {
+      return std::nullopt;
+    }
+
+    Event event{};
+    std::memcpy(&event, data, sizeof(Event));
+    return event;
+  }
+};
+
+/**
+ * @brief Registers an event type for an ingress.
+ *
+ * The decoder is a default constructible callable with the signature
+ * `std::optional<Event>(const std::byte *, std::size_t)`. It returns an empty
+ * optional if the payload is malformed.
+ *
+ * The id has to be known at compile time, e.g. a hashed string literal
+ * (`"ping"_hs`) or a constant of the wire protocol.
+ *
+ * @tparam Id Wire id of the event.
+ * @tparam Event The event type.
+ * @tparam Decoder The decoder of the payload.
+ */
+template <id_type Id, typename Event, typename Decoder = trivial_decoder<Event>>
+struct ingress_event {
+  /*! @brief Wire id of the event. */
+  static constexpr id_type id = Id;
+  /*! @brief Event type. */
+  using event_type = Event;
+  /*! @brief Decoder type. */
+  using decoder_type = Decoder;
+};
+
+/*! @brief Outcome of a raw dispatch. */
+enum class ingress_result {
+  /*! @brief The event has been decoded and dispatched. */
+  dispatched,
+  /*! @brief The event has been dispatched, but the machine didn't handle it. */
+  unhandled,
+  /*! @brief No event is registered for the id. */
+  unknown_id,
+  /*! @brief The decoder rejected the payload. */
+  malformed
+};
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+struct ingress_entry {
+  id_type id;
+  std::size_t index;
+};
+
+template <id_type... Ids>
+constexpr std::array<ingress_entry, sizeof...(Ids)> ingress_table() noexcept {
+  std::array<ingress_entry, sizeof...(Ids)> table{};
+  std::size_t next{};
+  ((table[next] = ingress_entry{Ids, next}, ++next), ...);
+
+  // insertion sort, the tables are small and this runs at compile time
+  for (std::size_t pos = 1u; pos < table.size(); ++pos) {
+    for (std::size_t curr = pos; curr && table[curr].id < table[curr - 1u].id;
+         --curr) {
+      const auto tmp = table[curr];
+      table[curr] = table[curr - 1u];
+      table[curr - 1u] = tmp;
+    }
+  }
+
+  return table;
+}
+
+template <std::size_t Count>
+constexpr bool
+ingress_unique(const std::array<ingress_entry, Count> &table) noexcept {
+  for (std::size_t pos = 1u; pos < Count; ++pos) {
+    if (table[pos].id == table[pos - 1u].id) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+/**
+ * @brief Decodes wire messages and dispatches them as typed events.
+ *
+ * Replaces the hand written switch over the ids of a protocol. The ids are
+ * sorted at compile time; a lookup is a binary search over a constant table of
+ * ids followed by a call through a constant table of function pointers. The
+ * event is decoded onto the stack, neither std::function nor the heap is
+ * involved.
+ *
+ * Works with every machine which has a templated dispatch(const Event &), e.g.
+ * fsm::fsm, new_fsm::StateMachine or state_machine. If dispatch returns
+ * something convertible to bool, false is reported as
+ * ingress_result::unhandled.
+ *
+ * @code{.cpp}
+ * using protocol = escad::ingress<escad::ingress_event<"ping"_hs, ping>,
+ *                                 escad::ingress_event<"pong"_hs, pong>>;
+ *
+ * auto result = protocol::dispatch_raw(machine, id, data, size);
+ * @endcode
+ *
+ * @tparam Events The registered events, see ingress_event.
+ */
+template <typename... Events> class ingress {
+  static_assert(sizeof...(Events) != 0u, "No events registered");
+
+  static constexpr std::size_t count = sizeof...(Events);
+
+  static constexpr auto table = details::ingress_table<Events::id...>();
+
+  static_assert(details::ingress_unique(table), "Duplicate event ids");
+
+  template <typename Machine, typename Event>
+  static ingress_result decode_and_dispatch(Machine &machine,
+                                            const std::byte *data,
+                                            std::size_t size) {
+    auto event = typename Event::decoder_type{}(data, size);
+
+    if (!event) {
+      return ingress_result::malformed;
+    }
+
+    using result_type = decltype(machine.dispatch(std::as_const(*event)));
+
+    if constexpr (std::is_convertible_v<result_type, bool>) {
+      return machine.dispatch(std::as_const(*event))
+                 ? ingress_result::dispatched
+                 : ingress_result::unhandled;
+    } else {
+      machine.dispatch(std::as_const(*event));
+      return ingress_result::dispatched;
+    }
+  }
+
+  template <typename Machine>
+  using handler_type = ingress_result (*)(Machine &, const std::byte *,
+                                          std::size_t);
+
+  template <typename Machine>
+  static constexpr std::array<handler_type<Machine>, count> handlers{
+      &decode_and_dispatch<Machine, Events>...};
+
+  static constexpr const details::ingress_entry *find(id_type id) noexcept {
+    std::size_t first{};
+    std::size_t last = count;
+
+    while (first < last) {
+      const auto middle = first + (last - first) / 2u;
+
+      if (table[middle].id < id) {
+        first = middle + 1u;
+      } else {
+        last = middle;
+      }
+    }
+
+    return (first < count && table[first].id == id) ? &table[first] : nullptr;
+  }
+
+public:
+  /**
+   * @brief Checks whether an id is registered.
+   * @param id Wire id of an event.
+   * @return True if an event is registered for the id, false otherwise.
+   */
+  [[nodiscard]] static constexpr bool contains(id_type id) noexcept {
+    return find(id) != nullptr;
+  }
+
+  /**
+   * @brief Decodes a payload and dispatches it to a machine.
+   *
+   * @tparam Machine Type of the state machine.
+   * @param machine The state machine to dispatch to.
+   * @param id Wire id of the event.
+   * @param data Payload of the message.
+   * @param size Size of the payload in bytes.
+   * @return The outcome of the dispatch.
+   */
+  template <typename Machine>
+  static ingress_result dispatch_raw(Machine &machine, id_type id,
+                                     const std::byte *data, std::size_t size) {
+    if (const auto *it = find(id); it) {
+      return handlers<Machine>[it->index](machine, data, size);
+    }
+
+    return ingress_result::unknown_id;
+  }
+};
+
+} // namespace escad
@@ -0,0 +1,115 @@
+/**
+ * @file state_change.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Compact state change record for queued observer notification
+ * @version 0.1
+ * @date 2024-03-11
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+#include "../base/forwards.h"
+#include "../signal/delegate.h"
+
+namespace escad {
+
+/**
+ * @brief Record of a single state transition.
+ *
+ * State machines which are connected to a dispatcher enqueue one of these per
+ * transition instead of notifying their observers synchronously. Observers
+ * connect to the dispatcher slot of state_change and receive the records when
+ * the owner of the dispatcher calls update(). With a concurrent_dispatcher,
+ * that is another thread than the one dispatching the events of the machine.
+ *
+ * The indices are the indices of the states within the state variant of the
+ * machine, so they can be compared against
+ * std::variant::index()/mpl::type_list_index_v.
+ */
+struct state_change {
+  using clock = std::chrono::steady_clock;
+
+  /*! @brief Id of the machine, as given when connecting the dispatcher. */
+  id_type machine;
+  /*! @brief Index of the state which has been left. */
+  std::uint32_t from;
+  /*! @brief Index of the state which has been entered. */
+  std::uint32_t to;
+  /*! @brief Point in time of the transition. */
+  clock::time_point timestamp;
+};
+
+/**
+ * @brief Queue of state changes of a state machine.
+ *
+ * A state machine holds one of these. It is empty by default, so nothing is
+ * enqueued unless the machine has been connected to a dispatcher.
+ *
+ * Any dispatcher with an enqueue<Type>(value) member works, in particular
+ * escad::dispatcher and escad::concurrent_dispatcher. A concurrent dispatcher
+ * must have its state_change queue prepared before it is frozen.
+ *
+ * @warning
+ * The dispatcher is not owned. Its lifetime must overcome the one of the state
+ * machine or the machine has to be disconnected before.
+ */
+class state_change_queue {
+  template <typename Dispatcher>
+  static void push(Dispatcher &dispatcher, state_change change) {
+    // a record rejected by a bounded queue is dropped, see its overflow policy
+    static_cast<void>(
+        dispatcher.template enqueue<state_change>(std::move(change)));
+  }
+
+public:
+  /**
+   * @brief Connects a dispatcher.
+   *
+   * @tparam Dispatcher Type of dispatcher.
+   * @param dispatcher Dispatcher to enqueue the state changes into.
+   * @param machine Id of the machine, reported in every state_change.
+   */
+  template <typename Dispatcher>
+  void connect(Dispatcher &dispatcher, id_type machine) noexcept {
+    sink_.template connect<&push<Dispatcher>>(dispatcher);
+    machine_ = machine;
+  }
+
+  /*! @brief Stops enqueuing state changes. */
+  void disconnect() noexcept { sink_.reset(); }
+
+  /**
+   * @brief Checks whether a dispatcher is connected.
+   * @return True if state changes are enqueued, false otherwise.
+   */
+  [[nodiscard]] explicit operator bool() const noexcept {
+    return static_cast<bool>(sink_);
+  }
+
+  /**
+   * @brief Enqueues a state change, if a dispatcher is connected.
+   *
+   * @param from Index of the state which has been left.
+   * @param to Index of the state which has been entered.
+   */
+  void enqueue(std::size_t from, std::size_t to) {
+    if (sink_) {
+      sink_(state_change{machine_, static_cast<std::uint32_t>(from),
+                         static_cast<std::uint32_t>(to),
+                         state_change::clock::now()});
+    }
+  }
+
+private:
+  delegate<void(state_change)> sink_{};
+  id_type machine_{};
+};
+
+} // namespace escad
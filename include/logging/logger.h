@@ -3,7 +3,7 @@
 #include <sstream>
 #include <string_view>
 
-#include "../signal/dispatcher.h"
+#include "../signal/concurrent_dispatcher.h"
 
 #include "logEvent.h"
 
@@ -15,10 +15,19 @@ namespace logging {
 
 using sv = std::string_view;
 
-class Logger : public escad::dispatcher {
+/**
+ * @brief Process wide log sink.
+ *
+ * Records are enqueued from any thread, they are delivered to the connected
+ * listeners by the thread which calls update().
+ */
+class Logger : public escad::concurrent_dispatcher {
 
 private:
-  Logger() {}
+  Logger() {
+    prepare<LogEvent>();
+    freeze();
+  }
 
   // static Logger *_logger;
 
@@ -25,6 +25,7 @@
 #include <variant>
 
 #include "../base/utils.h"
+#include "../fsm/state_change.h"
 
 #include "state.h"
 #include "transition.h"
@@ -79,12 +80,16 @@ public:
    * @tparam State The type of the state to be emplaced.
    */
   template <class State> void emplace() {
+    const auto from = states_.index();
+
     if constexpr (std::is_constructible_v<State, Context &>) {
       states_.template emplace<State>(context_);
     } else {
       states_.template emplace<State>();
     }
 
+    changes_.enqueue(from, states_.index());
+
     std::visit(overloaded{[](auto &state) { state.enter(); },
                           [](std::monostate) { ; }},
                states_);
@@ -108,11 +113,16 @@ public:
    * @param e The event to be passed to the state.
    */
   template <class State, class Event> void emplace(Event const &e) {
+    const auto from = states_.index();
+
     if constexpr (std::is_constructible_v<State, Context &>) {
       states_.template emplace<State>(context_);
     } else {
       states_.template emplace<State>();
     }
+
+    changes_.enqueue(from, states_.index());
+
     std::visit(overloaded{[&e](auto &state) {
                             // state.enter();
                             if (!state.enter(e)) {
@@ -289,9 +299,31 @@ public:
    */
   mpl::const_reference_t<Context> context() const { return context_; }
 
+  /**
+   * @brief Enqueues state changes into a dispatcher.
+   *
+   * Every emplaced state enqueues a state_change record into the dispatcher.
+   * The indices are indices into states_variant, so the index 0 (the
+   * std::monostate) is reported as origin of the very first state.
+   *
+   * @tparam Dispatcher escad::dispatcher or escad::concurrent_dispatcher.
+   * @param dispatcher The dispatcher to enqueue into, it is not owned.
+   * @param machine The id of this machine in the state_change records.
+   */
+  template <typename Dispatcher>
+  void connect_changes(Dispatcher &dispatcher, escad::id_type machine) {
+    changes_.connect(dispatcher, machine);
+  }
+
+  /**
+   * @brief Stops enqueuing state changes.
+   */
+  void disconnect_changes() { changes_.disconnect(); }
+
 private:
   states_variant states_;
   Context context_;
+  escad::state_change_queue changes_;
 };
 
 /**
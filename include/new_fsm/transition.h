@@ -100,7 +100,7 @@ public:
    * handled.
    * @param t The transitions object.
    */
-  transitions(transitions<detail::none>) noexcept
+  transitions(transitions<detail::none> const &) noexcept
       : idx{mpl::type_list_index_v<detail::none, list>}, outcome{result::none} {
   }
 
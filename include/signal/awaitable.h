@@ -0,0 +1,398 @@
+#pragma once
+
+// requires C++20, unlike the rest of the signal headers
+
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../base/type_info.h"
+#include "../base/utils.h"
+#include "../container/dense_map.h"
+#include "dispatcher.h"
+#include "forwards.h"
+#include "signal.h"
+
+namespace escad {
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+class awaiter_list;
+
+// lives in the coroutine frame, as part of the awaiter
+struct awaiter_node {
+  awaiter_list *owner{};
+  awaiter_node *prev{};
+  awaiter_node *next{};
+  std::coroutine_handle<> handle{};
+  // the arguments of the publish which resumed the coroutine
+  const void *payload{};
+};
+
+// intrusive doubly linked list, linking and unlinking never allocates
+class awaiter_list {
+ public:
+  awaiter_list() = default;
+
+  awaiter_list(const awaiter_list &) = delete;
+  awaiter_list &operator=(const awaiter_list &) = delete;
+
+  // awaiters left behind are never resumed
+  ~awaiter_list() {
+    while (pop_front()) {
+    }
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return head_ == nullptr; }
+
+  void push_back(awaiter_node &node) noexcept {
+    node.owner = this;
+    node.prev = tail_;
+    node.next = nullptr;
+    (tail_ ? tail_->next : head_) = &node;
+    tail_ = &node;
+  }
+
+  void erase(awaiter_node &node) noexcept {
+    (node.prev ? node.prev->next : head_) = node.next;
+    (node.next ? node.next->prev : tail_) = node.prev;
+    node.owner = nullptr;
+    node.prev = node.next = nullptr;
+  }
+
+  awaiter_node *pop_front() noexcept {
+    awaiter_node *node = head_;
+
+    if (node) {
+      erase(*node);
+    }
+
+    return node;
+  }
+
+  // resumes the coroutines waiting at call time, those that suspend again
+  // while resuming wait for the next round
+  void resume(const void *payload) {
+    awaiter_list pending;
+
+    while (auto *node = pop_front()) {
+      pending.push_back(*node);
+    }
+
+    // a resumed coroutine can destroy another one, which unlinks itself
+    while (auto *node = pending.pop_front()) {
+      node->payload = payload;
+      node->handle.resume();
+    }
+  }
+
+ private:
+  awaiter_node *head_{};
+  awaiter_node *tail_{};
+};
+
+template <typename... Type>
+struct awaited {
+  using type = std::tuple<Type &...>;
+};
+
+template <typename Type>
+struct awaited<Type> {
+  using type = Type &;
+};
+
+template <>
+struct awaited<> {
+  using type = void;
+};
+
+}  // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+/**
+ * @brief Awaitable returned by awaitable signals and dispatchers.
+ *
+ * Awaiting suspends the coroutine until the next publish and returns what has
+ * been published by reference: nothing for no arguments, a reference for a
+ * single argument, a tuple of references otherwise. The awaiter lives in the
+ * frame of the coroutine and links itself into the list of its source,
+ * awaiting never allocates.<br/>
+ * References are valid until the coroutine suspends again.
+ *
+ * @tparam Type Types of the published arguments.
+ */
+template <typename... Type>
+class event_awaiter : private details::awaiter_node {
+  using payload_type = std::tuple<Type *...>;
+
+ public:
+  /*! @brief Type returned by `co_await`. */
+  using result_type = typename details::awaited<Type...>::type;
+
+  /**
+   * @brief Constructs an awaiter for a given list.
+   * @param list The list to link into when suspending.
+   */
+  explicit event_awaiter(details::awaiter_list &list) noexcept : list_{&list} {}
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  event_awaiter(const event_awaiter &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This awaiter.
+   */
+  event_awaiter &operator=(const event_awaiter &) = delete;
+
+  /*! @brief Unlinks the awaiter if its coroutine is destroyed while waiting. */
+  ~event_awaiter() {
+    if (owner) {
+      owner->erase(*this);
+    }
+  }
+
+  /**
+   * @brief Always suspends, only future events are awaited.
+   * @return False.
+   */
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  /**
+   * @brief Links the awaiter into the list of its source.
+   * @param handle The suspended coroutine.
+   */
+  void await_suspend(const std::coroutine_handle<> handle) noexcept {
+    this->handle = handle;
+    list_->push_back(*this);
+  }
+
+  /**
+   * @brief Returns the published arguments.
+   * @return The published arguments, by reference.
+   */
+  result_type await_resume() const noexcept {
+    if constexpr (sizeof...(Type) != 0u) {
+      const auto &args = *static_cast<const payload_type *>(payload);
+
+      if constexpr (sizeof...(Type) == 1u) {
+        return *std::get<0u>(args);
+      } else {
+        return std::apply(
+            [](Type *...value) { return std::tuple<Type &...>{*value...}; },
+            args);
+      }
+    }
+  }
+
+ private:
+  details::awaiter_list *list_;
+};
+
+/**
+ * @brief Signal which coroutines can await.
+ *
+ * The interface is the one of the underlying signal, plus `next`:
+ *
+ * @code{.cpp}
+ * escad::awaitable_signal<void(my_event &)> sig;
+ * // within a coroutine
+ * my_event &event = co_await sig.next();
+ * @endcode
+ *
+ * Publishing invokes the listeners first, then resumes the coroutines waiting
+ * for the signal, inline and in the order they started waiting. Coroutines
+ * must not connect listeners to the same signal while they are resumed.<br/>
+ * Awaiters are resumed only by publishing through the awaitable signal, not
+ * through a reference to the underlying signal.
+ *
+ * @tparam Type A valid function type.
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template <typename Ret, typename... Args, typename Allocator>
+class awaitable_signal<Ret(Args...), Allocator>
+    : public signal<Ret(Args...), Allocator> {
+  static_assert(std::is_void_v<Ret>, "Awaitable signals return nothing");
+
+  using base_type = signal<Ret(Args...), Allocator>;
+
+ public:
+  /*! @brief Type returned by next. */
+  using awaiter_type = event_awaiter<std::remove_reference_t<Args>...>;
+
+  using base_type::base_type;
+
+  /*! @brief Default constructor. */
+  awaitable_signal() = default;
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  awaitable_signal(const awaitable_signal &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This signal.
+   */
+  awaitable_signal &operator=(const awaitable_signal &) = delete;
+
+  /**
+   * @brief Triggers a signal and resumes the awaiting coroutines.
+   * @param args Arguments to use to invoke listeners.
+   */
+  void publish(Args... args) const {
+    base_type::publish(args...);
+
+    if (!awaiters.empty()) {
+      const std::tuple<std::remove_reference_t<Args> *...> payload{&args...};
+      awaiters.resume(&payload);
+    }
+  }
+
+  /**
+   * @brief Triggers a signal for every element of a range and resumes the
+   * awaiting coroutines.
+   *
+   * Awaiting coroutines are resumed once per element, after all the listeners
+   * have handled the whole batch.
+   *
+   * @tparam It Type of forward iterator.
+   * @param first An iterator to the first element of the range.
+   * @param last An iterator past the last element of the range.
+   */
+  template <typename It>
+  void publish_batch(It first, It last) const {
+    base_type::publish_batch(first, last);
+
+    for (; first != last && !awaiters.empty(); ++first) {
+      // as if passed to publish, a reference binds and a value is copied
+      std::tuple_element_t<0u, std::tuple<Args...>> value = *first;
+      const std::tuple<std::remove_reference_t<Args> *...> payload{&value};
+      awaiters.resume(&payload);
+    }
+  }
+
+  /**
+   * @brief Triggers a signal for every element of a range and resumes the
+   * awaiting coroutines.
+   * @tparam Range Type of range, e.g. a vector or a span.
+   * @param range A range of elements.
+   */
+  template <typename Range>
+  void publish_batch(Range &&range) const {
+    publish_batch(std::begin(range), std::end(range));
+  }
+
+  /**
+   * @brief Returns an awaitable for the next publish.
+   * @return An awaitable for the next publish.
+   */
+  [[nodiscard]] awaiter_type next() const noexcept {
+    return awaiter_type{awaiters};
+  }
+
+  /**
+   * @brief Checks whether coroutines are waiting for the signal.
+   * @return True if at least a coroutine is waiting, false otherwise.
+   */
+  [[nodiscard]] bool awaited() const noexcept { return !awaiters.empty(); }
+
+ private:
+  mutable details::awaiter_list awaiters;
+};
+
+/**
+ * @brief Dispatcher whose events coroutines can await.
+ *
+ * The interface is the one of basic_dispatcher, plus `receive`:
+ *
+ * @code{.cpp}
+ * escad::awaitable_dispatcher dispatcher;
+ * // within a coroutine
+ * my_event &event = co_await dispatcher.receive<my_event>();
+ * @endcode
+ *
+ * Coroutines are resumed inline when an event is delivered, by `trigger` or
+ * during `update`, after the listeners and in the order they started waiting.
+ * The awaiters of a queue are attached as an owned listener, see `on`, the
+ * first time the queue is awaited. Detaching the owned listeners with `off`
+ * detaches the awaiters as well.
+ *
+ * @warning
+ * The first `receive` for a queue creates the queue if it doesn't exist yet
+ * and must not happen while the dispatcher is delivering events.
+ *
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template <typename Allocator>
+class basic_awaitable_dispatcher : public basic_dispatcher<Allocator> {
+  using base_type = basic_dispatcher<Allocator>;
+  using key_type = escad::id_type;
+  using mapped_type = std::shared_ptr<details::awaiter_list>;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using container_allocator = typename alloc_traits::template rebind_alloc<
+      std::pair<const key_type, mapped_type>>;
+  using container_type =
+      escad::dense_map<key_type, mapped_type, escad::identity,
+                       std::equal_to<key_type>, container_allocator>;
+
+ public:
+  /*! @brief Allocator type. */
+  using allocator_type = Allocator;
+
+  /*! @brief Default constructor. */
+  basic_awaitable_dispatcher()
+      : basic_awaitable_dispatcher{allocator_type{}} {}
+
+  /**
+   * @brief Constructs a dispatcher with a given allocator.
+   * @param allocator The allocator to use.
+   */
+  explicit basic_awaitable_dispatcher(const allocator_type &allocator)
+      : base_type{allocator}, lists{allocator} {}
+
+  /**
+   * @brief Returns an awaitable for the next event of a given queue.
+   * @tparam Type Type of event to await.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return An awaitable for the next event of the given queue.
+   */
+  template <typename Type>
+  [[nodiscard]] event_awaiter<Type> receive(
+      const escad::id_type id = escad::type_hash<Type>::value()) {
+    static_assert(std::is_same_v<Type, std::decay_t<Type>>,
+                  "Non-decayed types not allowed");
+    auto &&list = lists[id];
+
+    if (!list) {
+      list = std::allocate_shared<details::awaiter_list>(
+          this->get_allocator());
+
+      // the list has a stable address, the dispatcher can be moved
+      this->template on<Type>(id, [awaiters = list.get()](Type &event) {
+        if (!awaiters->empty()) {
+          const std::tuple<Type *> payload{&event};
+          awaiters->resume(&payload);
+        }
+      });
+    }
+
+    return event_awaiter<Type>{*list};
+  }
+
+ private:
+  container_type lists;
+};
+
+}  // namespace escad
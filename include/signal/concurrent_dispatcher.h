@@ -0,0 +1,840 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "../base/assert.h"
+#include "../base/compressed_pair.h"
+#include "../base/forwards.h"
+#include "../base/type_info.h"
+#include "../base/utils.h"
+#include "../container/dense_map.h"
+#include "forwards.h"
+#include "signal.h"
+
+namespace escad {
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+// unbounded multi-producer single-consumer queue, a linked list of nodes
+// where producers swap the head and the consumer follows the tail
+template <typename Type, typename Allocator>
+class mpsc_queue {
+  struct node {
+    std::atomic<node *> next{nullptr};
+    alignas(Type) unsigned char storage[sizeof(Type)];
+
+    Type &value() noexcept {
+      return *std::launder(reinterpret_cast<Type *>(storage));
+    }
+  };
+
+  using alloc_traits = typename std::allocator_traits<
+      Allocator>::template rebind_traits<node>;
+  using node_allocator = typename alloc_traits::allocator_type;
+
+  node *make_node() {
+    node_allocator allocator{alloc_};
+    node *elem = alloc_traits::allocate(allocator, 1u);
+    ::new (elem) node{};
+    return elem;
+  }
+
+  void drop_node(node *elem) noexcept {
+    node_allocator allocator{alloc_};
+    elem->~node();
+    alloc_traits::deallocate(allocator, elem, 1u);
+  }
+
+ public:
+  explicit mpsc_queue(const Allocator &allocator)
+      : alloc_{allocator}, head_{nullptr}, tail_{nullptr}, pending_{0u} {
+    tail_ = make_node();
+    head_.store(tail_, std::memory_order_relaxed);
+  }
+
+  mpsc_queue(const mpsc_queue &) = delete;
+  mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+  ~mpsc_queue() {
+    clear();
+    drop_node(tail_);
+  }
+
+  // any thread, never blocks
+  template <typename... Args>
+  void push(Args &&...args) {
+    node *elem = make_node();
+
+    if constexpr (std::is_aggregate_v<Type>) {
+      ::new (elem->storage) Type{std::forward<Args>(args)...};
+    } else {
+      ::new (elem->storage) Type(std::forward<Args>(args)...);
+    }
+
+    pending_.fetch_add(1u, std::memory_order_relaxed);
+    node *prev = head_.exchange(elem, std::memory_order_acq_rel);
+    prev->next.store(elem, std::memory_order_release);
+  }
+
+  // consumer only, visits the events pushed before the call at most, so that
+  // busy producers cannot keep the consumer in the loop forever
+  template <typename Func>
+  void drain(Func func) {
+    node *last = head_.load(std::memory_order_acquire);
+
+    while (tail_ != last) {
+      node *next = tail_->next.load(std::memory_order_acquire);
+
+      if (!next) {
+        // a producer is linking its node, it's picked up next time
+        break;
+      }
+
+      drop_node(tail_);
+      tail_ = next;
+      pending_.fetch_sub(1u, std::memory_order_relaxed);
+
+      func(next->value());
+      next->value().~Type();
+    }
+  }
+
+  // consumer only
+  void clear() noexcept {
+    drain([](Type &) {});
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return pending_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  Allocator alloc_;
+  alignas(64) std::atomic<node *> head_;
+  alignas(64) node *tail_;
+  std::atomic<std::size_t> pending_;
+};
+
+// bounded multi-producer single-consumer queue, a ring of cells allocated up
+// front where the sequence number of a cell tells whether it's free to write
+// for the producer at a position (twice the position) or ready to read for the
+// consumer (one more than that), doubled so that a single cell works as well
+template <typename Type, typename Allocator>
+class bounded_mpsc_queue {
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    alignas(Type) unsigned char storage[sizeof(Type)];
+
+    Type &value() noexcept {
+      return *std::launder(reinterpret_cast<Type *>(storage));
+    }
+  };
+
+  using alloc_traits = typename std::allocator_traits<
+      Allocator>::template rebind_traits<cell>;
+  using cell_allocator = typename alloc_traits::allocator_type;
+
+ public:
+  bounded_mpsc_queue(const Allocator &allocator, const std::size_t capacity)
+      : alloc_{allocator},
+        cells_{nullptr},
+        capacity_{capacity},
+        head_{0u},
+        tail_{0u} {
+    FSM_ASSERT(capacity_ != 0u, "Invalid capacity");
+    cells_ = alloc_traits::allocate(alloc_, capacity_);
+
+    for (std::size_t pos{}; pos < capacity_; ++pos) {
+      ::new (cells_ + pos) cell{};
+      cells_[pos].sequence.store(pos * 2u, std::memory_order_relaxed);
+    }
+  }
+
+  bounded_mpsc_queue(const bounded_mpsc_queue &) = delete;
+  bounded_mpsc_queue &operator=(const bounded_mpsc_queue &) = delete;
+
+  ~bounded_mpsc_queue() {
+    clear();
+
+    for (std::size_t pos{}; pos < capacity_; ++pos) {
+      cells_[pos].~cell();
+    }
+
+    alloc_traits::deallocate(alloc_, cells_, capacity_);
+  }
+
+  // any thread, fails without side effects when the ring is full
+  template <typename... Args>
+  bool push(Args &&...args) {
+    auto pos = head_.load(std::memory_order_relaxed);
+
+    for (;;) {
+      cell &elem = cells_[pos % capacity_];
+      const auto sequence = elem.sequence.load(std::memory_order_acquire);
+
+      if (sequence == pos * 2u) {
+        if (head_.compare_exchange_weak(pos, pos + 1u,
+                                        std::memory_order_relaxed)) {
+          if constexpr (std::is_aggregate_v<Type>) {
+            ::new (elem.storage) Type{std::forward<Args>(args)...};
+          } else {
+            ::new (elem.storage) Type(std::forward<Args>(args)...);
+          }
+
+          elem.sequence.store(pos * 2u + 1u, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos * 2u) {
+        // the cell still holds the event of the previous lap
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // consumer only, same guarantees as for the unbounded queue
+  template <typename Func>
+  void drain(Func func) {
+    const auto last = head_.load(std::memory_order_acquire);
+    auto pos = tail_.load(std::memory_order_relaxed);
+
+    while (pos != last) {
+      cell &elem = cells_[pos % capacity_];
+
+      if (elem.sequence.load(std::memory_order_acquire) != pos * 2u + 1u) {
+        // a producer is constructing its event, it's picked up next time
+        break;
+      }
+
+      func(elem.value());
+      elem.value().~Type();
+      elem.sequence.store((pos + capacity_) * 2u, std::memory_order_release);
+      tail_.store(++pos, std::memory_order_relaxed);
+    }
+  }
+
+  // consumer only
+  void clear() noexcept {
+    drain([](Type &) {});
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    const auto pos = tail_.load(std::memory_order_relaxed);
+    const auto last = head_.load(std::memory_order_relaxed);
+    return last > pos ? last - pos : 0u;
+  }
+
+ private:
+  cell_allocator alloc_;
+  cell *cells_;
+  std::size_t capacity_;
+  alignas(64) std::atomic<std::size_t> head_;
+  alignas(64) std::atomic<std::size_t> tail_;
+};
+
+struct basic_concurrent_dispatcher_handler {
+  virtual ~basic_concurrent_dispatcher_handler() = default;
+  virtual void publish() = 0;
+  virtual void disconnect(void *) = 0;
+  virtual void clear() noexcept = 0;
+  virtual std::size_t size() const noexcept = 0;
+  virtual std::size_t dropped() const noexcept = 0;
+};
+
+template <typename Type, typename Allocator>
+class concurrent_dispatcher_handler final
+    : public basic_concurrent_dispatcher_handler {
+  static_assert(std::is_same_v<Type, std::decay_t<Type>>, "Invalid type");
+  static_assert(std::is_move_constructible_v<Type>, "Invalid type");
+
+  using signal_type = signal<void(Type &), Allocator>;
+  using queue_type = mpsc_queue<Type, Allocator>;
+  using ring_type = bounded_mpsc_queue<Type, Allocator>;
+
+ public:
+  using allocator_type = Allocator;
+
+  concurrent_dispatcher_handler(const allocator_type &allocator)
+      : allocator_{allocator},
+        signal_{allocator},
+        events_{allocator},
+        ring_{} {}
+
+  void publish() override {
+    events_.drain([this](Type &event) { signal_.publish(event); });
+
+    if (ring_) {
+      ring_->drain([this](Type &event) { signal_.publish(event); });
+    }
+  }
+
+  void disconnect(void *instance) override { bucket().disconnect(instance); }
+
+  void clear() noexcept override {
+    events_.clear();
+
+    if (ring_) {
+      ring_->clear();
+    }
+  }
+
+  void bound(const std::size_t capacity, const overflow_policy policy) {
+    FSM_ASSERT(policy != overflow_policy::drop_oldest,
+               "Producers cannot drop events of the consumer");
+    policy_ = policy;
+
+    // pending events move to the unbounded list, which is delivered first
+    if (ring_) {
+      ring_->drain([this](Type &event) { events_.push(std::move(event)); });
+    }
+
+    if (capacity) {
+      ring_.emplace(allocator_, capacity);
+    } else {
+      ring_.reset();
+    }
+  }
+
+  [[nodiscard]] auto bucket() noexcept {
+    return typename signal_type::slot_type{signal_};
+  }
+
+  void trigger(Type event) { signal_.publish(event); }
+
+  template <typename... Args>
+  bool enqueue(Args &&...args) {
+    if (!ring_) {
+      events_.push(std::forward<Args>(args)...);
+      return true;
+    }
+
+    // arguments are consumed only once the event has a place in the ring
+    if (ring_->push(std::forward<Args>(args)...)) {
+      return true;
+    }
+
+    if (policy_ == overflow_policy::block) {
+      blocked_.fetch_add(1u, std::memory_order_relaxed);
+
+      do {
+        std::this_thread::yield();
+      } while (!ring_->push(std::forward<Args>(args)...));
+
+      return true;
+    }
+
+    dropped_.fetch_add(1u, std::memory_order_relaxed);
+    return false;
+  }
+
+  std::size_t size() const noexcept override {
+    return events_.size() + (ring_ ? ring_->size() : 0u);
+  }
+
+  std::size_t dropped() const noexcept override {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  std::size_t blocked() const noexcept {
+    return blocked_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  allocator_type allocator_;
+  signal_type signal_;
+  queue_type events_;
+  std::optional<ring_type> ring_;
+  overflow_policy policy_{};
+  std::atomic<std::size_t> dropped_{};
+  std::atomic<std::size_t> blocked_{};
+};
+
+}  // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+/**
+ * @brief Dispatcher which accepts events from any thread.
+ *
+ * The interface follows the one of basic_dispatcher. The difference is that
+ * every queue is a multi-producer single-consumer queue: events can be
+ * enqueued from any number of threads while a single consumer thread delivers
+ * them with `update`. Producers never block, neither on each other nor on the
+ * consumer, each enqueue allocates one node of the queue. Bounded queues are
+ * preallocated rings instead, see `bound`.
+ *
+ * Since creating a queue changes the pools, queues are registered up front:
+ *
+ * @code{.cpp}
+ * escad::concurrent_dispatcher dispatcher;
+ * dispatcher.prepare<my_event>();
+ * dispatcher.freeze();
+ * // from now on, any thread can enqueue a my_event
+ * @endcode
+ *
+ * Until `freeze` is called, the dispatcher behaves like basic_dispatcher and
+ * isn't thread safe. Afterwards the pools are read only. Enqueuing an event
+ * for which no queue is registered is then rejected. Everything but `enqueue`,
+ * `enqueue_hint` and `size` must still be called from the consumer thread.
+ *
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template <typename Allocator>
+class basic_concurrent_dispatcher {
+  template <typename Type>
+  using handler_type =
+      details::concurrent_dispatcher_handler<Type, Allocator>;
+
+  using key_type = escad::id_type;
+  // std::shared_ptr because of its type erased allocator which is pretty useful
+  // here
+  using mapped_type =
+      std::shared_ptr<details::basic_concurrent_dispatcher_handler>;
+
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using container_allocator = typename alloc_traits::template rebind_alloc<
+      std::pair<const key_type, mapped_type>>;
+  using container_type =
+      escad::dense_map<key_type, mapped_type, escad::identity,
+                       std::equal_to<key_type>, container_allocator>;
+
+  template <typename Type>
+  [[nodiscard]] handler_type<Type> &assure(const escad::id_type id) {
+    static_assert(std::is_same_v<Type, std::decay_t<Type>>,
+                  "Non-decayed types not allowed");
+
+    if (frozen_) {
+      auto *handler = find<Type>(id);
+      FSM_ASSERT(handler, "Queue not registered before freezing");
+      return *handler;
+    }
+
+    auto &&ptr = pools.first()[id];
+
+    if (!ptr) {
+      const auto &allocator = pools.second();
+      ptr = std::allocate_shared<handler_type<Type>>(allocator, allocator);
+    }
+
+    return static_cast<handler_type<Type> &>(*ptr);
+  }
+
+  template <typename Type>
+  [[nodiscard]] handler_type<Type> *find(const escad::id_type id) const {
+    if (auto it = pools.first().find(id); it != pools.first().cend()) {
+      return static_cast<handler_type<Type> *>(it->second.get());
+    }
+
+    return nullptr;
+  }
+
+  template <typename Type, typename... Args>
+  bool push(const escad::id_type id, Args &&...args) {
+    if (!frozen_) {
+      return notify_pending(assure<Type>(id).enqueue(std::forward<Args>(args)...));
+    } else if (auto *handler = find<Type>(id); handler) {
+      return notify_pending(handler->enqueue(std::forward<Args>(args)...));
+    }
+
+    return false;
+  }
+
+  // the fences pair with the one of rearm: either the producer sees the flag
+  // set or the consumer sees the event, a wake-up cannot get lost
+  bool notify_pending(const bool enqueued) const {
+    if (enqueued && notifier_) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (armed_.load(std::memory_order_relaxed) &&
+          armed_.exchange(false, std::memory_order_acq_rel)) {
+        notifier_();
+      }
+    }
+
+    return enqueued;
+  }
+
+  // consumer only
+  void rearm() const {
+    if (notifier_) {
+      armed_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (size() != 0u && armed_.exchange(false, std::memory_order_acq_rel)) {
+        notifier_();
+      }
+    }
+  }
+
+ public:
+  /*! @brief Allocator type. */
+  using allocator_type = Allocator;
+  /*! @brief Unsigned integer type. */
+  using size_type = std::size_t;
+
+  /*! @brief Default constructor. */
+  basic_concurrent_dispatcher()
+      : basic_concurrent_dispatcher{allocator_type{}} {}
+
+  /**
+   * @brief Constructs a dispatcher with a given allocator.
+   * @param allocator The allocator to use.
+   */
+  explicit basic_concurrent_dispatcher(const allocator_type &allocator)
+      : pools{allocator, allocator}, notifier_{}, armed_{false}, frozen_{false} {}
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  basic_concurrent_dispatcher(const basic_concurrent_dispatcher &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This dispatcher.
+   */
+  basic_concurrent_dispatcher &operator=(const basic_concurrent_dispatcher &) =
+      delete;
+
+  /**
+   * @brief Returns the associated allocator.
+   * @return The associated allocator.
+   */
+  [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
+    return pools.second();
+  }
+
+  /**
+   * @brief Registers the queue for a given event.
+   * @tparam Type Type of event for which to register a queue.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void prepare(const escad::id_type id = escad::type_hash<Type>::value()) {
+    FSM_ASSERT(!frozen_, "Dispatcher already frozen");
+    static_cast<void>(assure<Type>(id));
+  }
+
+  /**
+   * @brief Freezes the pools of the dispatcher.
+   *
+   * No queue can be added afterwards and events can be enqueued from any
+   * thread. Producer threads must be started after this call, or otherwise
+   * synchronize with it.
+   */
+  void freeze() noexcept { frozen_ = true; }
+
+  /**
+   * @brief Checks whether the pools of the dispatcher are frozen.
+   * @return True if the dispatcher is frozen, false otherwise.
+   */
+  [[nodiscard]] bool frozen() const noexcept { return frozen_; }
+
+  /**
+   * @brief Returns the number of pending events for a given type.
+   *
+   * While producers are running the value is a snapshot only.
+   *
+   * @tparam Type Type of event for which to return the count.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The number of pending events for the given type.
+   */
+  template <typename Type>
+  size_type size(
+      const escad::id_type id = escad::type_hash<Type>::value()) const noexcept {
+    if (auto *handler = find<Type>(id); handler) {
+      return handler->size();
+    }
+
+    return 0u;
+  }
+
+  /**
+   * @brief Returns the total number of pending events.
+   * @return The total number of pending events.
+   */
+  size_type size() const noexcept {
+    size_type count{};
+
+    for (auto &&cpool : pools.first()) {
+      count += cpool.second->size();
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Limits the number of pending events of a queue.
+   *
+   * The storage of a bounded queue is allocated up front, enqueuing never
+   * allocates afterwards. Once the queue is full, producers either see their
+   * events rejected or wait for the consumer to make room, depending on the
+   * policy. Rejected events and producers that had to wait are counted, see
+   * `dropped` and `blocked`. Dropping the oldest event isn't supported, since
+   * only the consumer can remove events from a queue.<br/>
+   * Queues are bounded before the dispatcher is frozen. A capacity of zero
+   * makes the queue unbounded again. Events already pending are kept and
+   * delivered by the next update, they don't count against the new capacity.
+   *
+   * @warning
+   * With a blocking policy, enqueuing from the consumer thread on a full queue
+   * never returns.
+   *
+   * @tparam Type Type of event of which to bound the queue.
+   * @param capacity Maximum number of pending events.
+   * @param policy What to do with events that don't fit.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void bound(const size_type capacity,
+             const overflow_policy policy = overflow_policy::reject_newest,
+             const escad::id_type id = escad::type_hash<Type>::value()) {
+    FSM_ASSERT(!frozen_, "Dispatcher already frozen");
+    assure<Type>(id).bound(capacity, policy);
+  }
+
+  /**
+   * @brief Returns the number of events a bounded queue has rejected.
+   * @tparam Type Type of event for which to return the count.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The number of rejected events of the given queue.
+   */
+  template <typename Type>
+  size_type dropped(
+      const escad::id_type id = escad::type_hash<Type>::value()) const noexcept {
+    if (auto *handler = find<Type>(id); handler) {
+      return handler->dropped();
+    }
+
+    return 0u;
+  }
+
+  /**
+   * @brief Returns the total number of events rejected by bounded queues.
+   * @return The total number of rejected events.
+   */
+  size_type dropped() const noexcept {
+    size_type count{};
+
+    for (auto &&cpool : pools.first()) {
+      count += cpool.second->dropped();
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Returns how many times producers waited on a full queue.
+   * @tparam Type Type of event for which to return the count.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The number of events that found the given queue full.
+   */
+  template <typename Type>
+  size_type blocked(
+      const escad::id_type id = escad::type_hash<Type>::value()) const noexcept {
+    if (auto *handler = find<Type>(id); handler) {
+      return handler->blocked();
+    }
+
+    return 0u;
+  }
+
+  /**
+   * @brief Returns a sink object for the given event and queue.
+   *
+   * Listeners are invoked on the consumer thread, they must be connected and
+   * disconnected from there as well.
+   *
+   * @sa basic_dispatcher::slot
+   *
+   * @tparam Type Type of event of which to get the sink.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return A temporary sink object.
+   */
+  template <typename Type>
+  [[nodiscard]] auto slot(
+      const escad::id_type id = escad::type_hash<Type>::value()) {
+    return assure<Type>(id).bucket();
+  }
+
+  /**
+   * @brief Triggers an immediate event of a given type.
+   * @tparam Type Type of event to trigger.
+   * @param value An instance of the given type of event.
+   */
+  template <typename Type>
+  void trigger(Type &&value = {}) {
+    trigger(escad::type_hash<std::decay_t<Type>>::value(),
+            std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Triggers an immediate event on a queue of a given type.
+   * @tparam Type Type of event to trigger.
+   * @param value An instance of the given type of event.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void trigger(const escad::id_type id, Type &&value = {}) {
+    assure<std::decay_t<Type>>(id).trigger(std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @tparam Args Types of arguments to use to construct the event.
+   * @param args Arguments to use to construct the event.
+   * @return True if the event has been enqueued, false otherwise.
+   */
+  template <typename Type, typename... Args>
+  bool enqueue(Args &&...args) {
+    return enqueue_hint<Type>(escad::type_hash<Type>::value(),
+                              std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @param value An instance of the given type of event.
+   * @return True if the event has been enqueued, false otherwise.
+   */
+  template <typename Type>
+  bool enqueue(Type &&value) {
+    return enqueue_hint(escad::type_hash<std::decay_t<Type>>::value(),
+                        std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   *
+   * Once frozen, an event for which no queue is registered is dropped. So is
+   * an event that doesn't fit a bounded queue which rejects the newest events.
+   *
+   * @tparam Type Type of event to enqueue.
+   * @tparam Args Types of arguments to use to construct the event.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @param args Arguments to use to construct the event.
+   * @return True if the event has been enqueued, false otherwise.
+   */
+  template <typename Type, typename... Args>
+  bool enqueue_hint(const escad::id_type id, Args &&...args) {
+    return push<Type>(id, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @param value An instance of the given type of event.
+   * @return True if the event has been enqueued, false otherwise.
+   */
+  template <typename Type>
+  bool enqueue_hint(const escad::id_type id, Type &&value) {
+    return push<std::decay_t<Type>>(id, std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Utility function to disconnect everything related to a given value
+   * or instance from a dispatcher.
+   * @tparam Type Type of class or type of payload.
+   * @param value_or_instance A valid object that fits the purpose.
+   */
+  template <typename Type>
+  void disconnect(Type &value_or_instance) {
+    disconnect(&value_or_instance);
+  }
+
+  /**
+   * @brief Utility function to disconnect everything related to a given value
+   * or instance from a dispatcher.
+   * @tparam Type Type of class or type of payload.
+   * @param value_or_instance A valid object that fits the purpose.
+   */
+  template <typename Type>
+  void disconnect(Type *value_or_instance) {
+    for (auto &&cpool : pools.first()) {
+      cpool.second->disconnect(value_or_instance);
+    }
+  }
+
+  /**
+   * @brief Discards all the events stored so far in a given queue.
+   * @tparam Type Type of event to discard.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void clear(const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).clear();
+    rearm();
+  }
+
+  /*! @brief Discards all the events queued so far. */
+  void clear() noexcept {
+    for (auto &&cpool : pools.first()) {
+      cpool.second->clear();
+    }
+
+    rearm();
+  }
+
+  /**
+   * @brief Delivers the pending events of a given queue.
+   *
+   * Events enqueued while delivering are left for the next update.
+   *
+   * @tparam Type Type of event to send.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void update(const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).publish();
+    rearm();
+  }
+
+  /*! @brief Delivers all the pending events. */
+  void update() const {
+    for (auto &&cpool : pools.first()) {
+      cpool.second->publish();
+    }
+
+    rearm();
+  }
+
+  /**
+   * @brief Sets the function invoked when events become pending.
+   *
+   * Same as basic_dispatcher::notifier, except that the notifier is invoked
+   * on the producer thread which enqueued the event that made the dispatcher
+   * non-empty, or on the consumer thread at the end of an update that leaves
+   * events pending. It cannot be changed while producers are running.
+   *
+   * @param func The function to invoke, it must be thread safe.
+   */
+  void notifier(const delegate<void()> func) {
+    notifier_ = func;
+    rearm();
+  }
+
+ private:
+  escad::compressed_pair<container_type, allocator_type> pools;
+  delegate<void()> notifier_;
+  // true while the notifier is waiting for an edge
+  mutable std::atomic<bool> armed_;
+  bool frozen_;
+};
+
+}  // namespace escad
@@ -0,0 +1,501 @@
+/**
+ * @file concurrent_signal.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Signal with lock free publication and snapshot based connections
+ * @version 0.1
+ * @date 2024-04-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "delegate.h"
+#include "forwards.h"
+#include "signal.h"
+
+namespace escad
+{
+    /**
+     * @brief Signal handler which can be published and modified concurrently.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a
+     * compile-time error unless the template parameter is a function type.
+     *
+     * @tparam Type A valid function type.
+     * @tparam Allocator Type of allocator used to manage memory and elements.
+     */
+    template <typename Type, typename Allocator>
+    class concurrent_signal;
+
+    /**
+     * @brief Signal handler which can be published and modified concurrently.
+     *
+     * Listeners are stored in immutable snapshots. Publishers read the current
+     * snapshot without taking any lock, they only announce themselves in one
+     * of two reader counters. Connecting or disconnecting a listener copies the
+     * current snapshot, modifies the copy and publishes it atomically. The old
+     * snapshot is retired and released once two grace periods have passed,
+     * that is once both reader counters have been observed empty after it was
+     * replaced.
+     *
+     * Writers never wait for publishers. Connecting and disconnecting from
+     * within a listener or from any other thread is safe, the change is seen
+     * by the next publication. Writers are serialized among themselves.
+     *
+     * Unlike signal, this class is neither copyable nor movable.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Allocator Type of allocator used to manage memory and elements.
+     */
+    template <typename Ret, typename... Args, typename Allocator>
+    class concurrent_signal<Ret(Args...), Allocator>
+    {
+        /*! @brief A slot is allowed to modify a signal. */
+        friend class slot<concurrent_signal<Ret(Args...), Allocator>>;
+
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using container_type = std::vector<delegate<Ret(Args...)>, typename alloc_traits::template rebind_alloc<delegate<Ret(Args...)>>>;
+
+        struct snapshot
+        {
+            snapshot(const container_type &other)
+                : calls{other} {}
+
+            container_type calls;
+            std::uint64_t retired{};
+        };
+
+        using snapshot_allocator = typename alloc_traits::template rebind_alloc<snapshot>;
+        using snapshot_traits = std::allocator_traits<snapshot_allocator>;
+        using retired_type = std::vector<snapshot *, typename alloc_traits::template rebind_alloc<snapshot *>>;
+
+        // keeps the two counters on distinct cache lines
+        struct alignas(64) reader_count
+        {
+            std::atomic<std::size_t> value{};
+        };
+
+        class read_guard
+        {
+        public:
+            read_guard(const concurrent_signal &owner) noexcept
+                : counter{&owner.readers[owner.epoch.load()].value}
+            {
+                counter->fetch_add(1u);
+            }
+
+            read_guard(const read_guard &) = delete;
+            read_guard &operator=(const read_guard &) = delete;
+
+            ~read_guard()
+            {
+                counter->fetch_sub(1u, std::memory_order_release);
+            }
+
+        private:
+            std::atomic<std::size_t> *counter;
+        };
+
+        template <typename Func>
+        void update(Func func)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            snapshot *old = current.load(std::memory_order_relaxed);
+
+            container_type calls{old ? old->calls : container_type{allocator}};
+            func(calls);
+
+            snapshot *next = nullptr;
+
+            if (!calls.empty())
+            {
+                snapshot_allocator snapshot_alloc{allocator};
+                next = snapshot_traits::allocate(snapshot_alloc, 1u);
+                snapshot_traits::construct(snapshot_alloc, next, calls);
+            }
+
+            current.store(next);
+
+            if (old)
+            {
+                old->retired = flips;
+                retired.push_back(old);
+            }
+
+            reclaim();
+        }
+
+        void reclaim()
+        {
+            for (bool progress = !retired.empty(); progress;)
+            {
+                progress = false;
+
+                if (confirmed != flips)
+                {
+                    // the parity left behind by the last flip has drained
+                    if (readers[epoch.load(std::memory_order_relaxed) ^ 1u].value.load() == 0u)
+                    {
+                        confirmed = flips;
+                        progress = true;
+                    }
+                }
+                else if (retired.front()->retired + 2u > confirmed)
+                {
+                    epoch.store(epoch.load(std::memory_order_relaxed) ^ 1u);
+                    ++flips;
+                    progress = true;
+                }
+
+                const auto last = std::find_if(retired.begin(), retired.end(), [this](const snapshot *elem)
+                                               { return elem->retired + 2u > confirmed; });
+
+                std::for_each(retired.begin(), last, [this](snapshot *elem)
+                              { release(elem); });
+                retired.erase(retired.begin(), last);
+                progress = progress && !retired.empty();
+            }
+        }
+
+        void release(snapshot *elem)
+        {
+            snapshot_allocator snapshot_alloc{allocator};
+            snapshot_traits::destroy(snapshot_alloc, elem);
+            snapshot_traits::deallocate(snapshot_alloc, elem, 1u);
+        }
+
+    public:
+        /*! @brief Allocator type. */
+        using allocator_type = Allocator;
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+        /*! @brief Slot type. */
+        using slot_type = slot<concurrent_signal<Ret(Args...), Allocator>>;
+
+        /*! @brief Default constructor. */
+        concurrent_signal() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
+            : concurrent_signal{allocator_type{}} {}
+
+        /**
+         * @brief Constructs a signal handler with a given allocator.
+         * @param allocator The allocator to use.
+         */
+        explicit concurrent_signal(const allocator_type &allocator) noexcept
+            : allocator{allocator},
+              retired{allocator} {}
+
+        /*! @brief Default copy constructor, deleted on purpose. */
+        concurrent_signal(const concurrent_signal &) = delete;
+
+        /**
+         * @brief Default copy assignment operator, deleted on purpose.
+         * @return This signal handler.
+         */
+        concurrent_signal &operator=(const concurrent_signal &) = delete;
+
+        /**
+         * @brief Destructor.
+         *
+         * @warning
+         * No publication may be running while the signal is destroyed.
+         */
+        ~concurrent_signal()
+        {
+            if (auto *last = current.load(); last)
+            {
+                release(last);
+            }
+
+            for (auto *elem : retired)
+            {
+                release(elem);
+            }
+        }
+
+        /**
+         * @brief Returns the associated allocator.
+         * @return The associated allocator.
+         */
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
+        {
+            return allocator;
+        }
+
+        /**
+         * @brief Number of listeners connected to the signal.
+         * @return Number of listeners currently connected.
+         */
+        [[nodiscard]] size_type size() const noexcept
+        {
+            read_guard guard{*this};
+            const snapshot *curr = current.load();
+            return curr ? curr->calls.size() : 0u;
+        }
+
+        /**
+         * @brief Returns false if at least a listener is connected to the signal.
+         * @return True if the signal has no listeners connected, false otherwise.
+         */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return current.load() == nullptr;
+        }
+
+        /**
+         * @brief Number of replaced snapshots which are not released yet.
+         * @return Number of snapshots waiting for their grace periods.
+         */
+        [[nodiscard]] size_type retired_size() const
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            return retired.size();
+        }
+
+        /**
+         * @brief Triggers a signal.
+         *
+         * All the listeners of the current snapshot are notified. Order isn't
+         * guaranteed.
+         *
+         * @param args Arguments to use to invoke listeners.
+         */
+        void publish(Args... args) const
+        {
+            read_guard guard{*this};
+
+            if (const snapshot *curr = current.load(); curr)
+            {
+                for (auto &&call : curr->calls)
+                {
+                    call(args...);
+                }
+            }
+        }
+
+        /**
+         * @brief Collects return values from the listeners.
+         *
+         * See signal::collect for the requirements of the collector.
+         *
+         * @tparam Func Type of collector to use, if any.
+         * @param func A valid function object.
+         * @param args Arguments to use to invoke listeners.
+         */
+        template <typename Func>
+        void collect(Func func, Args... args) const
+        {
+            read_guard guard{*this};
+            const snapshot *curr = current.load();
+
+            if (!curr)
+            {
+                return;
+            }
+
+            for (auto &&call : curr->calls)
+            {
+                if constexpr (std::is_void_v<Ret>)
+                {
+                    if constexpr (std::is_invocable_r_v<bool, Func>)
+                    {
+                        call(args...);
+                        if (func())
+                        {
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        call(args...);
+                        func();
+                    }
+                }
+                else
+                {
+                    if constexpr (std::is_invocable_r_v<bool, Func, Ret>)
+                    {
+                        if (func(call(args...)))
+                        {
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        func(call(args...));
+                    }
+                }
+            }
+        }
+
+    private:
+        allocator_type allocator;
+        std::atomic<snapshot *> current{};
+        mutable reader_count readers[2u]{};
+        std::atomic<std::size_t> epoch{};
+        // writer side only, protected by mutex
+        mutable std::mutex mutex{};
+        retired_type retired;
+        std::uint64_t flips{};
+        std::uint64_t confirmed{};
+    };
+
+    /**
+     * @brief Slot class for concurrent signals.
+     *
+     * Same as the slot of a signal, except that listeners are always appended.
+     * Every connect and disconnect publishes a new snapshot of the listeners.
+     *
+     * @warning
+     * Lifetime of a slot must not overcome that of the signal to which it refers.
+     * In any other case, attempting to use a slot results in undefined behavior.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Allocator Type of allocator used to manage memory and elements.
+     */
+    template <typename Ret, typename... Args, typename Allocator>
+    class slot<concurrent_signal<Ret(Args...), Allocator>>
+    {
+        using signal_type = concurrent_signal<Ret(Args...), Allocator>;
+
+        template <auto Candidate, typename Type>
+        static void release(Type value_or_instance, void *signal, std::uint64_t)
+        {
+            slot{*static_cast<signal_type *>(signal)}.disconnect<Candidate>(value_or_instance);
+        }
+
+        template <auto Candidate>
+        static void release(void *signal, std::uint64_t)
+        {
+            slot{*static_cast<signal_type *>(signal)}.disconnect<Candidate>();
+        }
+
+    public:
+        /**
+         * @brief Constructs a slot that is allowed to modify a given signal.
+         * @param ref A valid reference to a signal object.
+         */
+        slot(concurrent_signal<Ret(Args...), Allocator> &ref) noexcept
+            : _signal{&ref} {}
+
+        /**
+         * @brief Returns false if at least a listener is connected to the slot.
+         * @return True if the slot has no listeners connected, false otherwise.
+         */
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _signal->empty();
+        }
+
+        /**
+         * @brief Connects a free function (with or without payload), a bound or an
+         * unbound member to a signal.
+         *
+         * See slot::connect of signal for details.
+         *
+         * @tparam Candidate Function or member to connect to the signal.
+         * @tparam Type Type of class or type of payload, if any.
+         * @param value_or_instance A valid object that fits the purpose, if any.
+         * @return A properly initialized connection object.
+         */
+        template <auto Candidate, typename... Type>
+        connection connect(Type &&...value_or_instance)
+        {
+            delegate<Ret(Args...)> call{};
+            call.template connect<Candidate>(value_or_instance...);
+
+            _signal->update([&call](auto &calls)
+                            {
+                calls.erase(std::remove(calls.begin(), calls.end(), call), calls.end());
+                calls.push_back(std::move(call)); });
+
+            delegate<void(void *, std::uint64_t)> conn{};
+            conn.template connect<&release<Candidate, Type...>>(value_or_instance...);
+            return {std::move(conn), _signal};
+        }
+
+        /**
+         * @brief Disconnects a free function (with or without payload), a bound or
+         * an unbound member from a signal.
+         * @tparam Candidate Function or member to disconnect from the signal.
+         * @tparam Type Type of class or type of payload, if any.
+         * @param value_or_instance A valid object that fits the purpose, if any.
+         */
+        template <auto Candidate, typename... Type>
+        void disconnect(Type &&...value_or_instance)
+        {
+            delegate<Ret(Args...)> call{};
+            call.template connect<Candidate>(value_or_instance...);
+
+            _signal->update([&call](auto &calls)
+                            { calls.erase(std::remove(calls.begin(), calls.end(), call), calls.end()); });
+        }
+
+        /**
+         * @brief Disconnects free functions with payload or bound members from a
+         * signal.
+         * @tparam Type Type of class or type of payload.
+         * @param value_or_instance A valid object that fits the purpose.
+         */
+        template <typename Type>
+        void disconnect(Type &value_or_instance)
+        {
+            disconnect(&value_or_instance);
+        }
+
+        /**
+         * @brief Disconnects free functions with payload or bound members from a
+         * signal.
+         * @tparam Type Type of class or type of payload.
+         * @param value_or_instance A valid object that fits the purpose.
+         */
+        template <typename Type>
+        void disconnect(Type *value_or_instance)
+        {
+            if (value_or_instance)
+            {
+                _signal->update([value_or_instance](auto &calls)
+                                {
+                    auto predicate = [value_or_instance](const auto &delegate)
+                    { return delegate.data() == value_or_instance; };
+                    calls.erase(std::remove_if(calls.begin(), calls.end(), std::move(predicate)), calls.end()); });
+            }
+        }
+
+        /*! @brief Disconnects all the listeners from a signal. */
+        void disconnect()
+        {
+            _signal->update([](auto &calls)
+                            { calls.clear(); });
+        }
+
+    private:
+        signal_type *_signal;
+    };
+
+    /**
+     * @brief Deduction guide.
+     *
+     * It allows to deduce the signal handler type of a slot directly from the
+     * concurrent signal it refers to.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Allocator Type of allocator used to manage memory and elements.
+     */
+    template <typename Ret, typename... Args, typename Allocator>
+    slot(concurrent_signal<Ret(Args...), Allocator> &) -> slot<concurrent_signal<Ret(Args...), Allocator>>;
+
+} // namespace escad
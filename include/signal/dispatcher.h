@@ -1,22 +1,63 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "../base/assert.h"
 #include "../base/compressed_pair.h"
 #include "../base/forwards.h"
 #include "../base/type_info.h"
 #include "../base/utils.h"
 #include "../container/dense_map.h"
+#include "../container/small_vector.h"
 #include "forwards.h"
+#include "inplace_delegate.h"
 #include "signal.h"
 
 namespace escad {
 
+/**
+ * @brief Coalescing policy of the dispatcher queues.
+ *
+ * By default, every enqueued event is delivered. Specializing this class
+ * template with a static member function `key` turns the queues of a type
+ * into coalescing queues:
+ *
+ * @code{.cpp}
+ * template<>
+ * struct escad::coalesce_traits<position> {
+ *     static entity_id key(const position &event) { return event.entity; }
+ * };
+ * @endcode
+ *
+ * A coalescing queue holds at most one pending event per key. An event whose
+ * key is already queued replaces the pending one in place, so that only the
+ * latest value is delivered, at the position of the first one.
+ *
+ * @tparam Type Type of event.
+ */
+template <typename Type, typename = void>
+struct coalesce_traits {};
+
+/*! @brief Delivery statistics of a dispatcher queue, see `update_parallel`. */
+struct drain_stats {
+  /*! @brief Number of parallel updates which delivered events. */
+  std::size_t drains{};
+  /*! @brief Number of events delivered. */
+  std::size_t events{};
+  /*! @brief Time spent delivering the events. */
+  std::chrono::steady_clock::duration time{};
+};
+
 /**
  * @cond TURN_OFF_DOXYGEN
  * Internal details not to be documented.
@@ -24,12 +65,59 @@ namespace escad {
 
 namespace details {
 
+template <typename Type, typename Allocator, typename = void>
+struct coalescing_index {
+  static constexpr bool enabled = false;
+
+  explicit coalescing_index(const Allocator &) noexcept {}
+};
+
+template <typename Type, typename Allocator>
+struct coalescing_index<
+    Type, Allocator,
+    std::void_t<decltype(coalesce_traits<Type>::key(std::declval<const Type &>()))>> {
+  static constexpr bool enabled = true;
+
+  using key_type = std::decay_t<decltype(coalesce_traits<Type>::key(
+      std::declval<const Type &>()))>;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using container_type = escad::dense_map<
+      key_type, std::size_t, std::hash<key_type>, std::equal_to<key_type>,
+      typename alloc_traits::template rebind_alloc<
+          std::pair<const key_type, std::size_t>>>;
+
+  explicit coalescing_index(const Allocator &allocator) : slots{allocator} {}
+
+  [[nodiscard]] static key_type key(const Type &event) {
+    return coalesce_traits<Type>::key(event);
+  }
+
+  // maps the keys to the positions of the pending events
+  container_type slots;
+};
+
 struct basic_dispatcher_handler {
   virtual ~basic_dispatcher_handler() = default;
-  virtual void publish() = 0;
+  virtual std::size_t publish(std::size_t) = 0;
   virtual void disconnect(void *) = 0;
   virtual void clear() noexcept = 0;
   virtual std::size_t size() const noexcept = 0;
+  virtual std::size_t dropped() const noexcept = 0;
+
+  // delivers all the pending events and accounts for them
+  void drain() {
+    if (const auto count = size(); count != 0u) {
+      const auto start = std::chrono::steady_clock::now();
+      const auto done = publish(count);
+      stats.time += std::chrono::steady_clock::now() - start;
+      stats.events += done;
+      ++stats.drains;
+    }
+  }
+
+  // queues of different groups are drained concurrently by update_parallel
+  std::size_t group{};
+  drain_stats stats{};
 };
 
 template <typename Type, typename Allocator>
@@ -40,47 +128,232 @@ class dispatcher_handler final : public basic_dispatcher_handler {
   using signal_type = signal<void(Type &), Allocator>;
   using container_type =
       std::vector<Type, typename alloc_traits::template rebind_alloc<Type>>;
+  using index_type = coalescing_index<Type, Allocator>;
+  using listener_type = inplace_delegate<void(Type &)>;
+  using listener_container = std::vector<
+      listener_type,
+      typename alloc_traits::template rebind_alloc<listener_type>>;
+
+  void notify(Type &event) {
+    signal_.publish(event);
+
+    for (auto &&listener : listeners_) {
+      listener(event);
+    }
+  }
 
  public:
   using allocator_type = Allocator;
 
   dispatcher_handler(const allocator_type &allocator)
-      : signal_{allocator}, events_{allocator} {}
+      : signal_{allocator},
+        listeners_{allocator},
+        events_{allocator},
+        index_{allocator},
+        overflow_{} {}
+
+  // delivers at most count of the events queued at call time
+  std::size_t publish(std::size_t count) override {
+    // delivered events can't make room while listeners enqueue, a bounded
+    // queue starts from the front so that they have at least capacity slots
+    if (capacity_ && cursor_) {
+      compact();
+    }
 
-  void publish() override {
-    const auto length = events_.size();
+    const auto last = cursor_ + std::min(count, events_.size() - cursor_);
+    std::size_t done{};
+    delivering_ = true;
 
-    for (std::size_t pos{}; pos < length; ++pos) {
-      signal_.publish(events_[pos]);
+    while (cursor_ < last) {
+      if constexpr (index_type::enabled) {
+        // events enqueued from now on go to the back of the queue
+        index_.slots.erase(index_type::key(events_[cursor_]));
+      }
+
+      const auto next = cursor_ + 1u;
+      notify(events_[cursor_++]);
+      ++done;
+
+      // a listener cleared the queue, what's enqueued since then waits for
+      // the next call
+      if (cursor_ < next) {
+        break;
+      }
+    }
+
+    delivering_ = false;
+
+    // delivered events are dropped in bulk, once they are the majority
+    if (cursor_ == events_.size()) {
+      events_.clear();
+      cursor_ = 0u;
+    } else if (cursor_ > events_.size() / 2u) {
+      compact();
     }
 
-    events_.erase(events_.cbegin(), events_.cbegin() + length);
+    return done;
   }
 
   void disconnect(void *instance) override { bucket().disconnect(instance); }
 
-  void clear() noexcept override { events_.clear(); }
+  void clear() noexcept override {
+    events_.clear();
+    cursor_ = 0u;
+
+    if constexpr (index_type::enabled) {
+      index_.slots.clear();
+    }
+  }
 
   [[nodiscard]] auto bucket() noexcept {
     return typename signal_type::slot_type{signal_};
   }
 
-  void trigger(Type event) { signal_.publish(event); }
+  template <typename Func>
+  void on(Func &&func) {
+    listeners_.emplace_back(std::forward<Func>(func));
+  }
+
+  void off() noexcept { listeners_.clear(); }
+
+  void bound(const std::size_t capacity, const overflow_policy policy,
+             listener_type overflow) {
+    FSM_ASSERT(policy != overflow_policy::block,
+               "Blocking requires a concurrent dispatcher");
+    capacity_ = capacity;
+    policy_ = policy;
+    overflow_ = std::move(overflow);
+
+    // twice the capacity, delivered events are dropped before it's exhausted
+    events_.reserve(capacity * 2u);
+
+    if constexpr (index_type::enabled) {
+      index_.slots.reserve(capacity);
+    }
+  }
+
+  void trigger(Type event) { notify(event); }
 
   template <typename... Args>
-  void enqueue(Args &&...args) {
-    if constexpr (std::is_aggregate_v<Type>) {
-      events_.push_back(Type{std::forward<Args>(args)...});
+  bool enqueue(Args &&...args) {
+    if constexpr (index_type::enabled) {
+      return coalesce(make(std::forward<Args>(args)...));
     } else {
-      events_.emplace_back(std::forward<Args>(args)...);
+      if (capacity_ && size() >= capacity_) {
+        if (policy_ == overflow_policy::reject_newest) {
+          if (overflow_) {
+            auto event = make(std::forward<Args>(args)...);
+            overflow_(event);
+          }
+
+          ++dropped_;
+          return false;
+        }
+
+        drop_oldest();
+      }
+
+      reclaim();
+
+      if constexpr (std::is_aggregate_v<Type>) {
+        events_.push_back(Type{std::forward<Args>(args)...});
+      } else {
+        events_.emplace_back(std::forward<Args>(args)...);
+      }
+
+      return true;
     }
   }
 
-  std::size_t size() const noexcept override { return events_.size(); }
+  std::size_t size() const noexcept override {
+    return events_.size() - cursor_;
+  }
+
+  std::size_t dropped() const noexcept override { return dropped_; }
 
  private:
+  template <typename... Args>
+  [[nodiscard]] static Type make(Args &&...args) {
+    if constexpr (std::is_aggregate_v<Type>) {
+      return Type{std::forward<Args>(args)...};
+    } else {
+      return Type(std::forward<Args>(args)...);
+    }
+  }
+
+  void compact() {
+    events_.erase(events_.cbegin(), events_.cbegin() + cursor_);
+
+    if constexpr (index_type::enabled) {
+      for (auto &&slot : index_.slots) {
+        slot.second -= cursor_;
+      }
+    }
+
+    cursor_ = 0u;
+  }
+
+  // makes room at the back of a bounded queue without reallocating, events
+  // can't be moved around while they are being delivered though
+  void reclaim() {
+    if (capacity_ && cursor_ && !delivering_ &&
+        events_.size() == events_.capacity()) {
+      compact();
+    }
+  }
+
+  void drop_oldest() {
+    auto &oldest = events_[cursor_];
+
+    if constexpr (index_type::enabled) {
+      index_.slots.erase(index_type::key(oldest));
+    }
+
+    if (overflow_) {
+      overflow_(oldest);
+    }
+
+    ++cursor_;
+    ++dropped_;
+  }
+
+  bool coalesce(Type event) {
+    auto key = index_type::key(event);
+
+    if (auto it = index_.slots.find(key); it != index_.slots.end()) {
+      events_[it->second] = std::move(event);
+      return true;
+    }
+
+    if (capacity_ && size() >= capacity_) {
+      if (policy_ == overflow_policy::reject_newest) {
+        if (overflow_) {
+          overflow_(event);
+        }
+
+        ++dropped_;
+        return false;
+      }
+
+      drop_oldest();
+    }
+
+    reclaim();
+    events_.push_back(std::move(event));
+    index_.slots.insert_or_assign(std::move(key), events_.size() - 1u);
+    return true;
+  }
+
   signal_type signal_;
+  listener_container listeners_;
   container_type events_;
+  index_type index_;
+  listener_type overflow_;
+  std::size_t cursor_{};
+  std::size_t capacity_{};
+  std::size_t dropped_{};
+  overflow_policy policy_{};
+  bool delivering_{};
 };
 
 }  // namespace details
@@ -100,7 +373,15 @@ class dispatcher_handler final : public basic_dispatcher_handler {
  * type `Type &`, no matter what the return type is.
  *
  * The dispatcher creates instances of the `sigh` class internally. Refer to the
- * documentation of the latter for more details.
+ * documentation of the latter for more details.<br/>
+ * Listeners that carry their own state, e.g. capturing lambdas, can be handed
+ * over to the dispatcher with `on`. They are stored in inplace delegates and
+ * are invoked after the listeners connected through the sink.<br/>
+ * Queues of types with a coalesce_traits specialization keep only the latest
+ * pending event per key.<br/>
+ * Queues mapped with the default id of their type are found through the type
+ * index, see `type_index`, without a hash lookup. Queues with custom ids go
+ * through the hashed map.
  *
  * @tparam Allocator Type of allocator used to manage memory and elements.
  */
@@ -121,10 +402,39 @@ class basic_dispatcher {
       escad::dense_map<key_type, mapped_type, escad::identity, std::equal_to<key_type>,
                 container_allocator>;
 
+  using index_allocator = typename alloc_traits::template rebind_alloc<
+      details::basic_dispatcher_handler *>;
+  using index_container =
+      std::vector<details::basic_dispatcher_handler *, index_allocator>;
+
   template <typename Type>
   [[nodiscard]] handler_type<Type> &assure(const escad::id_type id) {
     static_assert(std::is_same_v<Type, std::decay_t<Type>>,
                   "Non-decayed types not allowed");
+
+    // queues with the default id are also indexed by type, without hashing
+    if (id == escad::type_hash<Type>::value()) {
+      const auto index = escad::type_index<Type>::value();
+
+      if (index < by_index.size() && by_index[index]) {
+        return static_cast<handler_type<Type> &>(*by_index[index]);
+      }
+
+      auto &handler = assure_hashed<Type>(id);
+
+      if (index >= by_index.size()) {
+        by_index.resize(index + 1u);
+      }
+
+      by_index[index] = &handler;
+      return handler;
+    }
+
+    return assure_hashed<Type>(id);
+  }
+
+  template <typename Type>
+  [[nodiscard]] handler_type<Type> &assure_hashed(const escad::id_type id) {
     auto &&ptr = pools.first()[id];
 
     if (!ptr) {
@@ -135,6 +445,89 @@ class basic_dispatcher {
     return static_cast<handler_type<Type> &>(*ptr);
   }
 
+  // round robin over the queues, starting where the last call stopped
+  template <typename Expired>
+  std::size_t update_with_budget(std::size_t budget,
+                                 const std::size_t quantum, Expired expired) {
+    auto &&container = pools.first();
+    const auto count = container.size();
+
+    for (bool progress = true; budget && progress && !expired();) {
+      std::size_t busy{};
+
+      for (auto &&cpool : container) {
+        busy += (cpool.second->size() != 0u);
+      }
+
+      if (!busy) {
+        break;
+      }
+
+      const auto share =
+          std::min(quantum, std::max(budget / busy, std::size_t{1u}));
+      progress = false;
+
+      for (std::size_t visited{}; visited < count && budget; ++visited) {
+        next_pool = next_pool < count ? next_pool : 0u;
+        const auto offset = static_cast<std::ptrdiff_t>(next_pool);
+        const auto done =
+            container.begin()[offset].second->publish(std::min(share, budget));
+        ++next_pool;
+        budget -= done;
+        progress = progress || done != 0u;
+
+        if (done && expired()) {
+          break;
+        }
+      }
+    }
+
+    const auto pending = size();
+    rearm(pending);
+    return pending;
+  }
+
+  // drains the queues of a group, possibly on another thread
+  struct group_task {
+    void run() {
+      for (auto &&cpool : *container) {
+        if (cpool.second->group == group) {
+          cpool.second->drain();
+        }
+      }
+
+      remaining->fetch_sub(1u, std::memory_order_release);
+    }
+
+    const container_type *container;
+    std::size_t group;
+    std::atomic<std::size_t> *remaining;
+  };
+
+  using task_allocator =
+      typename alloc_traits::template rebind_alloc<group_task>;
+
+  bool notify_pending(const bool enqueued) {
+    if (enqueued && armed_) {
+      armed_ = false;
+      notifier_();
+    }
+
+    return enqueued;
+  }
+
+  // events left after an update count as a new edge, so that consumers that
+  // wait for the notifier don't sleep on pending events
+  void rearm(const std::size_t pending) const {
+    if (notifier_) {
+      armed_ = (pending == 0u);
+
+      if (!armed_) {
+        notifier_();
+      }
+    }
+  }
+
  public:
   /*! @brief Allocator type. */
   using allocator_type = Allocator;
@@ -149,14 +542,18 @@ class basic_dispatcher {
    * @param allocator The allocator to use.
    */
   explicit basic_dispatcher(const allocator_type &allocator)
-      : pools{allocator, allocator} {}
+      : pools{allocator, allocator}, by_index{allocator} {}
 
   /**
    * @brief Move constructor.
    * @param other The instance to move from.
    */
   basic_dispatcher(basic_dispatcher &&other) noexcept
-      : pools{std::move(other.pools)} {}
+      : pools{std::move(other.pools)},
+        by_index{std::move(other.by_index)},
+        notifier_{std::exchange(other.notifier_, {})},
+        next_pool{other.next_pool},
+        armed_{std::exchange(other.armed_, false)} {}
 
   /**
    * @brief Allocator-extended move constructor.
@@ -166,7 +563,11 @@ class basic_dispatcher {
   basic_dispatcher(basic_dispatcher &&other,
                    const allocator_type &allocator) noexcept
       : pools{container_type{std::move(other.pools.first()), allocator},
-              allocator} {}
+              allocator},
+        by_index{std::move(other.by_index), allocator},
+        notifier_{std::exchange(other.notifier_, {})},
+        next_pool{other.next_pool},
+        armed_{std::exchange(other.armed_, false)} {}
 
   /**
    * @brief Move assignment operator.
@@ -175,6 +576,10 @@ class basic_dispatcher {
    */
   basic_dispatcher &operator=(basic_dispatcher &&other) noexcept {
     pools = std::move(other.pools);
+    by_index = std::move(other.by_index);
+    notifier_ = std::exchange(other.notifier_, {});
+    next_pool = other.next_pool;
+    armed_ = std::exchange(other.armed_, false);
     return *this;
   }
 
@@ -185,6 +590,10 @@ class basic_dispatcher {
   void swap(basic_dispatcher &other) {
     using std::swap;
     swap(pools, other.pools);
+    swap(by_index, other.by_index);
+    swap(notifier_, other.notifier_);
+    swap(next_pool, other.next_pool);
+    swap(armed_, other.armed_);
   }
 
   /**
@@ -224,6 +633,83 @@ class basic_dispatcher {
     return count;
   }
 
+  /**
+   * @brief Returns the number of events a bounded queue has discarded.
+   * @tparam Type Type of event for which to return the count.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The number of rejected or dropped events of the given queue.
+   */
+  template <typename Type>
+  size_type dropped(
+      const escad::id_type id = escad::type_hash<Type>::value()) const noexcept {
+    if (auto it = pools.first().find(id); it != pools.first().cend()) {
+      return it->second->dropped();
+    }
+
+    return 0u;
+  }
+
+  /**
+   * @brief Returns the total number of events discarded by bounded queues.
+   * @return The total number of rejected or dropped events.
+   */
+  size_type dropped() const noexcept {
+    size_type count{};
+
+    for (auto &&cpool : pools.first()) {
+      count += cpool.second->dropped();
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Limits the number of pending events of a queue.
+   *
+   * Storage for the given number of events is allocated up front, so that
+   * enqueuing never allocates afterwards. Once the queue is full, the policy
+   * decides whether the new event is rejected or the oldest pending one is
+   * dropped. Either way the discarded event is counted, see `dropped`.<br/>
+   * A capacity of zero makes the queue unbounded again.
+   *
+   * @warning
+   * Delivered events are only reclaimed between updates. Listeners can enqueue
+   * up to `capacity` events while their queue is being delivered, beyond that
+   * the storage grows.
+   *
+   * @tparam Type Type of event of which to bound the queue.
+   * @param capacity Maximum number of pending events.
+   * @param policy What to do with events that don't fit.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void bound(const size_type capacity,
+             const overflow_policy policy = overflow_policy::reject_newest,
+             const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).bound(capacity, policy, {});
+  }
+
+  /**
+   * @brief Limits the number of pending events of a queue.
+   *
+   * The callback is invoked with every event that is discarded, before it's
+   * destroyed. It must fit the inline storage of an
+   * `inplace_delegate<void(Type &)>`.
+   *
+   * @tparam Type Type of event of which to bound the queue.
+   * @tparam Func Type of callback.
+   * @param capacity Maximum number of pending events.
+   * @param policy What to do with events that don't fit.
+   * @param func Callback invoked with the discarded events.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type, typename Func,
+            typename = std::enable_if_t<std::is_invocable_v<Func &, Type &>>>
+  void bound(const size_type capacity, const overflow_policy policy, Func func,
+             const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).bound(capacity, policy, std::move(func));
+  }
+
   /**
    * @brief Returns a sink object for the given event and queue.
    *
@@ -248,6 +734,48 @@ class basic_dispatcher {
     return assure<Type>(id).bucket();
   }
 
+  /**
+   * @brief Registers an owned listener for the given event and queue.
+   *
+   * The listener is moved into the dispatcher and is invoked with an argument
+   * of type `Type &`. It must fit the inline storage of an
+   * `inplace_delegate<void(Type &)>`, larger listeners are rejected at compile
+   * time.
+   *
+   * @tparam Type Type of event to which to connect the listener.
+   * @tparam Func Type of listener.
+   * @param func The listener to register.
+   */
+  template <typename Type, typename Func>
+  void on(Func &&func) {
+    on<Type>(escad::type_hash<Type>::value(), std::forward<Func>(func));
+  }
+
+  /**
+   * @brief Registers an owned listener for the given event and queue.
+   * @tparam Type Type of event to which to connect the listener.
+   * @tparam Func Type of listener.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @param func The listener to register.
+   */
+  template <typename Type, typename Func>
+  void on(const escad::id_type id, Func &&func) {
+    assure<Type>(id).on(std::forward<Func>(func));
+  }
+
+  /**
+   * @brief Destroys the owned listeners of a given queue.
+   *
+   * Listeners connected through the sink aren't affected.
+   *
+   * @tparam Type Type of event of which to destroy the listeners.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void off(const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).off();
+  }
+
   /**
    * @brief Triggers an immediate event of a given type.
    * @tparam Type Type of event to trigger.
@@ -274,21 +802,24 @@ class basic_dispatcher {
    * @tparam Type Type of event to enqueue.
    * @tparam Args Types of arguments to use to construct the event.
    * @param args Arguments to use to construct the event.
+   * @return False if a bounded queue rejected the event, true otherwise.
    */
   template <typename Type, typename... Args>
-  void enqueue(Args &&...args) {
-    enqueue_hint<Type>(escad::type_hash<Type>::value(), std::forward<Args>(args)...);
+  bool enqueue(Args &&...args) {
+    return enqueue_hint<Type>(escad::type_hash<Type>::value(),
+                              std::forward<Args>(args)...);
   }
 
   /**
    * @brief Enqueues an event of the given type.
    * @tparam Type Type of event to enqueue.
    * @param value An instance of the given type of event.
+   * @return False if a bounded queue rejected the event, true otherwise.
    */
   template <typename Type>
-  void enqueue(Type &&value) {
-    enqueue_hint(escad::type_hash<std::decay_t<Type>>::value(),
-                 std::forward<Type>(value));
+  bool enqueue(Type &&value) {
+    return enqueue_hint(escad::type_hash<std::decay_t<Type>>::value(),
+                        std::forward<Type>(value));
   }
 
   /**
@@ -297,10 +828,11 @@ class basic_dispatcher {
    * @tparam Args Types of arguments to use to construct the event.
    * @param id Name used to map the event queue within the dispatcher.
    * @param args Arguments to use to construct the event.
+   * @return False if a bounded queue rejected the event, true otherwise.
    */
   template <typename Type, typename... Args>
-  void enqueue_hint(const escad::id_type id, Args &&...args) {
-    assure<Type>(id).enqueue(std::forward<Args>(args)...);
+  bool enqueue_hint(const escad::id_type id, Args &&...args) {
+    return notify_pending(assure<Type>(id).enqueue(std::forward<Args>(args)...));
   }
 
   /**
@@ -308,10 +840,12 @@ class basic_dispatcher {
    * @tparam Type Type of event to enqueue.
    * @param id Name used to map the event queue within the dispatcher.
    * @param value An instance of the given type of event.
+   * @return False if a bounded queue rejected the event, true otherwise.
    */
   template <typename Type>
-  void enqueue_hint(const escad::id_type id, Type &&value) {
-    assure<std::decay_t<Type>>(id).enqueue(std::forward<Type>(value));
+  bool enqueue_hint(const escad::id_type id, Type &&value) {
+    return notify_pending(
+        assure<std::decay_t<Type>>(id).enqueue(std::forward<Type>(value)));
   }
 
   /**
@@ -346,6 +880,7 @@ class basic_dispatcher {
   template <typename Type>
   void clear(const escad::id_type id = escad::type_hash<Type>::value()) {
     assure<Type>(id).clear();
+    rearm(size());
   }
 
   /*! @brief Discards all the events queued so far. */
@@ -353,6 +888,8 @@ class basic_dispatcher {
     for (auto &&cpool : pools.first()) {
       cpool.second->clear();
     }
+
+    rearm(0u);
   }
 
   /**
@@ -362,18 +899,187 @@ class basic_dispatcher {
    */
   template <typename Type>
   void update(const escad::id_type id = escad::type_hash<Type>::value()) {
-    assure<Type>(id).publish();
+    auto &handler = assure<Type>(id);
+    handler.publish(handler.size());
+    rearm(size());
   }
 
   /*! @brief Delivers all the pending events. */
   void update() const {
     for (auto &&cpool : pools.first()) {
-      cpool.second->publish();
+      cpool.second->publish(cpool.second->size());
     }
+
+    rearm(size());
+  }
+
+  /**
+   * @brief Delivers at most a given number of pending events.
+   *
+   * The budget is shared among the queues with pending events, which are
+   * visited round robin. The next call resumes with the queue following the
+   * last one served, so that no queue starves.
+   *
+   * @param budget Maximum number of events to deliver.
+   * @return The number of events still pending.
+   */
+  size_type update(const size_type budget) {
+    return update_with_budget(budget, budget, []() { return false; });
+  }
+
+  /**
+   * @brief Delivers pending events until a deadline.
+   *
+   * Queues are visited round robin as for the budgeted update. The clock is
+   * checked after every small batch of events, a single listener running
+   * late isn't interrupted.
+   *
+   * @param deadline Point in time after which no more events are delivered.
+   * @return The number of events still pending.
+   */
+  size_type update(const std::chrono::steady_clock::time_point deadline) {
+    return update_with_budget(
+        (std::numeric_limits<size_type>::max)(), deadline_batch,
+        [deadline]() { return std::chrono::steady_clock::now() >= deadline; });
+  }
+
+  /**
+   * @brief Assigns a queue to an independence group.
+   *
+   * Queues are in group 0 unless assigned otherwise. Queues of different
+   * groups are drained at the same time by `update_parallel`, their listeners
+   * must not share state.
+   *
+   * @tparam Type Type of event of the queue.
+   * @param group Independence group of the queue.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void group(const size_type group,
+             const escad::id_type id = escad::type_hash<Type>::value()) {
+    assure<Type>(id).group = group;
+  }
+
+  /**
+   * @brief Returns the delivery statistics of a given queue.
+   *
+   * Statistics are collected by `update_parallel` only.
+   *
+   * @tparam Type Type of event of the queue.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The delivery statistics of the given queue.
+   */
+  template <typename Type>
+  [[nodiscard]] drain_stats stats(
+      const escad::id_type id = escad::type_hash<Type>::value()) const {
+    if (auto it = pools.first().find(id); it != pools.first().cend()) {
+      return it->second->stats;
+    }
+
+    return {};
+  }
+
+  /*! @brief Resets the delivery statistics of all the queues. */
+  void reset_stats() noexcept {
+    for (auto &&cpool : pools.first()) {
+      cpool.second->stats = {};
+    }
+  }
+
+  /**
+   * @brief Delivers all the pending events, independence groups in parallel.
+   *
+   * Every group with pending events but one is handed to the executor as a
+   * task, the remaining one is drained on the calling thread. Within a group,
+   * queues are drained one after the other as for `update`. The call returns
+   * once all the groups are drained.<br/>
+   * The executor is invoked with a `delegate<void()>` and must run it exactly
+   * once, e.g. by posting it to a thread pool:
+   *
+   * @code{.cpp}
+   * dispatcher.group<physics_event>(1u);
+   * dispatcher.group<audio_event>(2u);
+   * dispatcher.update_parallel([&pool](escad::delegate<void()> task) { pool.post(task); });
+   * @endcode
+   *
+   * The time spent on every queue is accounted for, see `stats`.
+   *
+   * @warning
+   * Listeners must not enqueue or trigger events on the dispatcher, nor
+   * create queues, while it's updated in parallel.
+   *
+   * @tparam Executor Type of executor.
+   * @param executor A valid executor.
+   */
+  template <typename Executor>
+  void update_parallel(Executor &&executor) {
+    const auto &container = pools.first();
+    std::atomic<size_type> remaining{};
+    escad::small_vector<group_task, 8u, task_allocator> tasks{
+        task_allocator{pools.second()}};
+
+    for (auto &&cpool : container) {
+      const auto group = cpool.second->group;
+
+      if (cpool.second->size() != 0u &&
+          std::none_of(tasks.begin(), tasks.end(),
+                       [group](const auto &task) { return task.group == group; })) {
+        tasks.push_back(group_task{&container, group, &remaining});
+      }
+    }
+
+    if (!tasks.empty()) {
+      remaining.store(tasks.size(), std::memory_order_relaxed);
+
+      // tasks don't move anymore, the executor can refer to them
+      for (auto it = tasks.begin() + 1; it != tasks.end(); ++it) {
+        executor(delegate<void()>{connect_arg<&group_task::run>, *it});
+      }
+
+      tasks.begin()->run();
+
+      while (remaining.load(std::memory_order_acquire) != 0u) {
+        std::this_thread::yield();
+      }
+    }
+
+    rearm(size());
+  }
+
+  /**
+   * @brief Sets the function invoked when events become pending.
+   *
+   * The notifier is edge triggered: it's invoked by the first enqueue on an
+   * empty dispatcher and then not again until an update or a clear empties
+   * the dispatcher. An update that leaves events pending invokes it as well,
+   * so that a consumer which sleeps until notified never misses work. If
+   * events are already pending, the notifier is invoked immediately.<br/>
+   * An empty delegate removes the notifier.
+   *
+   * @code{.cpp}
+   * escad::eventfd_notifier wakeup;
+   * dispatcher.notifier({escad::connect_arg<&escad::eventfd_notifier::notify>, wakeup});
+   * @endcode
+   *
+   * @param func The function to invoke.
+   */
+  void notifier(const delegate<void()> func) {
+    notifier_ = func;
+    armed_ = false;
+    rearm(size());
   }
 
  private:
+  // events delivered between two checks of the clock
+  static constexpr size_type deadline_batch = 16u;
+
   escad::compressed_pair<container_type, allocator_type> pools;
+  // handlers of the default ids by type index, owned by the pools
+  index_container by_index;
+  delegate<void()> notifier_{};
+  size_type next_pool{};
+  // true while nothing is pending and the notifier is waiting for an edge
+  mutable bool armed_{};
 };
 
 }  // namespace signal
@@ -2,14 +2,16 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <type_traits>
 #include <utility>
-#include "../container/dense_map.h"
+#include <vector>
 #include "../base/compressed_pair.h"
 //#include "../core/fwd.hpp"
 #include "../base/type_info.h"
 #include "../base/utils.h"
 #include "forwards.h"
+#include "inplace_delegate.h"
 
 namespace escad {
 
@@ -27,19 +29,34 @@ namespace escad {
  * Handlers for the different events are created internally on the fly. It's not
  * required to specify in advance the full list of accepted events.<br/>
  * Moreover, whenever an event is published, an emitter also passes a reference
- * to itself to its listeners.
+ * to itself to its listeners.<br/>
+ * Listeners are stored in inplace delegates, registering one never allocates
+ * beyond the slot in the handler table.<br/>
+ * The table is indexed by the sequential identifier of the event types, see
+ * `type_index`, so that publishing doesn't hash.
  *
  * @tparam Derived Emitter type.
  * @tparam Allocator Type of allocator used to manage memory and elements.
  */
 template<typename Derived, typename Allocator>
 class emitter {
-    using key_type = escad::id_type;
-    using mapped_type = std::function<void(void *)>;
+    using mapped_type = inplace_delegate<void(void *, Derived &)>;
 
     using alloc_traits = std::allocator_traits<Allocator>;
-    using container_allocator = typename alloc_traits::template rebind_alloc<std::pair<const key_type, mapped_type>>;
-    using container_type = escad::dense_map<key_type, mapped_type, escad::identity, std::equal_to<key_type>, container_allocator>;
+    using container_allocator = typename alloc_traits::template rebind_alloc<mapped_type>;
+    using container_type = std::vector<mapped_type, container_allocator>;
+
+    template<typename Type>
+    [[nodiscard]] static std::size_t index() noexcept {
+        return escad::type_index<std::remove_cv_t<std::remove_reference_t<Type>>>::value();
+    }
+
+    template<typename Type>
+    [[nodiscard]] mapped_type *find() noexcept {
+        auto &&container = handlers.first();
+        const auto pos = index<Type>();
+        return (pos < container.size() && container[pos]) ? &container[pos] : nullptr;
+    }
 
 public:
     /*! @brief Allocator type. */
@@ -60,7 +77,7 @@ public:
 
     /*! @brief Default destructor. */
     virtual ~emitter() noexcept {
-        static_assert(std::is_base_of_v<emitter<Derived>, Derived>, "Invalid emitter type");
+        static_assert(std::is_base_of_v<emitter<Derived, Allocator>, Derived>, "Invalid emitter type");
     }
 
     /**
@@ -68,7 +85,8 @@ public:
      * @param other The instance to move from.
      */
     emitter(emitter &&other) noexcept
-        : handlers{std::move(other.handlers)} {}
+        : handlers{std::move(other.handlers)},
+          count{std::exchange(other.count, 0u)} {}
 
     /**
      * @brief Allocator-extended move constructor.
@@ -76,7 +94,8 @@ public:
      * @param allocator The allocator to use.
      */
     emitter(emitter &&other, const allocator_type &allocator) noexcept
-        : handlers{container_type{std::move(other.handlers.first()), allocator}, allocator} {}
+        : handlers{container_type{std::move(other.handlers.first()), allocator}, allocator},
+          count{std::exchange(other.count, 0u)} {}
 
     /**
      * @brief Move assignment operator.
@@ -85,6 +104,7 @@ public:
      */
     emitter &operator=(emitter &&other) noexcept {
         handlers = std::move(other.handlers);
+        count = std::exchange(other.count, 0u);
         return *this;
     }
 
@@ -95,6 +115,7 @@ public:
     void swap(emitter &other) {
         using std::swap;
         swap(handlers, other.handlers);
+        swap(count, other.count);
     }
 
     /**
@@ -112,8 +133,42 @@ public:
      */
     template<typename Type>
     void publish(Type &&value) {
-        if(const auto id = escad::type_id<Type>().hash(); handlers.first().contains(id)) {
-            handlers.first()[id](&value);
+        if(auto *handler = find<Type>(); handler) {
+            (*handler)(&value, static_cast<Derived &>(*this));
+        }
+    }
+
+    /**
+     * @brief Registers a listener with the event emitter.
+     *
+     * The listener is invoked with a reference to the event and a reference to
+     * the emitter. Listeners that don't fit the inline storage of the handlers,
+     * that is `inplace_delegate<void(void *, Derived &)>::inline_size` bytes,
+     * are moved to the heap.
+     *
+     * @tparam Type Type of event to which to connect the listener.
+     * @tparam Func Type of listener.
+     * @param func The listener to register.
+     */
+    template<typename Type, typename Func>
+    void on(Func func) {
+        auto &&container = handlers.first();
+        const auto pos = index<Type>();
+
+        if(pos >= container.size()) {
+            container.resize(pos + 1u);
+        }
+
+        count += !container[pos];
+
+        if constexpr(mapped_type::template fits_inline<Func>) {
+            container[pos] = mapped_type{[func = std::move(func)](void *value, Derived &owner) mutable {
+                func(*static_cast<Type *>(value), owner);
+            }};
+        } else {
+            container[pos] = mapped_type{[func = std::make_unique<Func>(std::move(func))](void *value, Derived &owner) {
+                (*func)(*static_cast<Type *>(value), owner);
+            }};
         }
     }
 
@@ -124,9 +179,7 @@ public:
      */
     template<typename Type>
     void on(std::function<void(Type &, Derived &)> func) {
-        handlers.first().insert_or_assign(escad::type_id<Type>().hash(), [func = std::move(func), this](void *value) {
-            func(*static_cast<Type *>(value), static_cast<Derived &>(*this));
-        });
+        on<Type, std::function<void(Type &, Derived &)>>(std::move(func));
     }
 
     /**
@@ -135,12 +188,16 @@ public:
      */
     template<typename Type>
     void erase() {
-        handlers.first().erase(escad::type_hash<std::remove_cv_t<std::remove_reference_t<Type>>>::value());
+        if(auto *handler = find<Type>(); handler) {
+            *handler = mapped_type{};
+            --count;
+        }
     }
 
     /*! @brief Disconnects all the listeners. */
     void clear() noexcept {
         handlers.first().clear();
+        count = 0u;
     }
 
     /**
@@ -150,7 +207,9 @@ public:
      */
     template<typename Type>
     [[nodiscard]] bool contains() const {
-        return handlers.first().contains(escad::type_hash<std::remove_cv_t<std::remove_reference_t<Type>>>::value());
+        const auto &container = handlers.first();
+        const auto pos = index<Type>();
+        return pos < container.size() && static_cast<bool>(container[pos]);
     }
 
     /**
@@ -158,11 +217,12 @@ public:
      * @return True if there are no listeners registered, false otherwise.
      */
     [[nodiscard]] bool empty() const noexcept {
-        return handlers.first().empty();
+        return count == 0u;
     }
 
 private:
     escad::compressed_pair<container_type, allocator_type> handlers;
+    size_type count{};
 };
 
 } // namespace signal
@@ -11,19 +11,42 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 namespace escad {
 
+/*! @brief What a bounded event queue does with an event that doesn't fit. */
+enum class overflow_policy {
+    /*! @brief The new event is rejected. */
+    reject_newest,
+    /*! @brief The oldest pending event is dropped to make room. */
+    drop_oldest,
+    /*! @brief The producer waits for the consumer, concurrent queues only. */
+    block
+};
+
 template<typename>
 class delegate;
 
+template<typename, std::size_t = sizeof(void *) * 4u, std::size_t = alignof(void *)>
+class inplace_delegate;
+
 template<typename = std::allocator<void>>
 class basic_dispatcher;
 
+template<typename = std::allocator<void>>
+class basic_concurrent_dispatcher;
+
+template<typename = std::allocator<void>>
+class basic_ordered_dispatcher;
+
 template<typename, typename = std::allocator<void>>
 class emitter;
 
+template<typename, typename...>
+class static_emitter;
+
 class connection;
 
 struct scoped_connection;
@@ -31,10 +54,40 @@ struct scoped_connection;
 template<typename>
 class slot;
 
-template<typename Type, typename = std::allocator<void>>
+template<typename Type, typename = std::allocator<void>, std::size_t = 0u>
 class signal;
 
+/**
+ * @brief Alias declaration for signals with inline storage.
+ * @tparam Type A valid function type.
+ * @tparam InlineSize Number of listeners stored without allocating.
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template<typename Type, std::size_t InlineSize, typename Allocator = std::allocator<void>>
+using small_signal = signal<Type, Allocator, InlineSize>;
+
+template<typename Type, typename = std::allocator<void>>
+class concurrent_signal;
+
+template<typename, typename = std::allocator<void>>
+class awaitable_signal;
+
+template<typename, auto...>
+class static_signal;
+
+template<typename = std::allocator<void>>
+class basic_awaitable_dispatcher;
+
 /*! @brief Alias declaration for the most common use case. */
 using dispatcher = basic_dispatcher<>;
 
+/*! @brief Alias declaration for the most common use case. */
+using concurrent_dispatcher = basic_concurrent_dispatcher<>;
+
+/*! @brief Alias declaration for the most common use case. */
+using ordered_dispatcher = basic_ordered_dispatcher<>;
+
+/*! @brief Alias declaration for the most common use case. */
+using awaitable_dispatcher = basic_awaitable_dispatcher<>;
+
 } // namespace signal
\ No newline at end of file
@@ -0,0 +1,248 @@
+/**
+ * @file inplace_delegate.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Owning delegate with fixed inline storage
+ * @version 0.1
+ * @date 2024-04-15
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "../base/assert.h"
+#include "forwards.h"
+
+namespace escad
+{
+    /**
+     * @brief Owning delegate with inline storage.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a
+     * compile-time error unless the template parameter is a function type.
+     *
+     * @tparam Type A valid function type.
+     * @tparam Size Size of the inline storage in bytes.
+     * @tparam Align Alignment of the inline storage.
+     */
+    template <typename Type, std::size_t Size, std::size_t Align>
+    class inplace_delegate;
+
+    /**
+     * @brief Owning delegate with inline storage.
+     *
+     * Unlike delegate, an inplace delegate owns its callable, so that capturing
+     * lambdas and other function objects carry their state along. The callable
+     * is stored in a buffer within the delegate itself and it never allocates.
+     * Callables that don't fit into the buffer are rejected at compile time.
+     *
+     * Inplace delegates are move only.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Size Size of the inline storage in bytes.
+     * @tparam Align Alignment of the inline storage.
+     */
+    template <typename Ret, typename... Args, std::size_t Size, std::size_t Align>
+    class inplace_delegate<Ret(Args...), Size, Align>
+    {
+        struct operations
+        {
+            Ret (*invoke)(void *, Args...);
+            // both null for trivially copyable callables
+            void (*move)(void *, void *) noexcept;
+            void (*destroy)(void *) noexcept;
+        };
+
+        template <typename Func>
+        static Ret invoke(void *storage, Args... args)
+        {
+            return static_cast<Ret>(std::invoke(*static_cast<Func *>(storage), std::forward<Args>(args)...));
+        }
+
+        template <typename Func>
+        static void move(void *to, void *from) noexcept
+        {
+            ::new (to) Func(std::move(*static_cast<Func *>(from)));
+            static_cast<Func *>(from)->~Func();
+        }
+
+        template <typename Func>
+        static void destroy(void *storage) noexcept
+        {
+            static_cast<Func *>(storage)->~Func();
+        }
+
+        template <typename Func>
+        static constexpr bool is_trivial = std::is_trivially_copyable_v<Func> && std::is_trivially_destructible_v<Func>;
+
+        template <typename Func>
+        static constexpr operations table{
+            &invoke<Func>,
+            is_trivial<Func> ? nullptr : &move<Func>,
+            is_trivial<Func> ? nullptr : &destroy<Func>};
+
+        void steal(inplace_delegate &other) noexcept
+        {
+            if (other.ops)
+            {
+                if (other.ops->move)
+                {
+                    other.ops->move(&storage, &other.storage);
+                }
+                else
+                {
+                    std::memcpy(&storage, &other.storage, Size);
+                }
+
+                ops = std::exchange(other.ops, nullptr);
+            }
+        }
+
+    public:
+        /*! @brief Size of the inline storage in bytes. */
+        static constexpr std::size_t inline_size = Size;
+        /*! @brief Alignment of the inline storage. */
+        static constexpr std::size_t inline_align = Align;
+
+        /**
+         * @brief Checks whether a callable can be stored inline.
+         * @tparam Func Type of callable.
+         */
+        template <typename Func>
+        static constexpr bool fits_inline = sizeof(Func) <= Size && Align % alignof(Func) == 0u && std::is_nothrow_move_constructible_v<Func>;
+
+        /*! @brief Default constructor. */
+        inplace_delegate() noexcept
+            : ops{nullptr} {}
+
+        /**
+         * @brief Constructs a delegate from a callable.
+         * @tparam Func Type of callable.
+         * @param func The callable to store.
+         */
+        template <typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, inplace_delegate> && std::is_invocable_r_v<Ret, std::decay_t<Func> &, Args...>>>
+        inplace_delegate(Func &&func)
+            : inplace_delegate{}
+        {
+            emplace(std::forward<Func>(func));
+        }
+
+        /*! @brief Default copy constructor, deleted on purpose. */
+        inplace_delegate(const inplace_delegate &) = delete;
+
+        /**
+         * @brief Move constructor.
+         * @param other The instance to move from.
+         */
+        inplace_delegate(inplace_delegate &&other) noexcept
+            : inplace_delegate{}
+        {
+            steal(other);
+        }
+
+        /*! @brief Destroys the callable, if any. */
+        ~inplace_delegate()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Default copy assignment operator, deleted on purpose.
+         * @return This delegate.
+         */
+        inplace_delegate &operator=(const inplace_delegate &) = delete;
+
+        /**
+         * @brief Move assignment operator.
+         * @param other The instance to move from.
+         * @return This delegate.
+         */
+        inplace_delegate &operator=(inplace_delegate &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                steal(other);
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Replaces the callable of a delegate.
+         * @tparam Func Type of callable.
+         * @param func The callable to store.
+         */
+        template <typename Func>
+        void emplace(Func &&func)
+        {
+            using callable_type = std::decay_t<Func>;
+
+            static_assert(std::is_invocable_r_v<Ret, callable_type &, Args...>, "Invalid callable");
+            static_assert(sizeof(callable_type) <= Size, "Callable doesn't fit the inline storage");
+            static_assert(Align % alignof(callable_type) == 0u, "Callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<callable_type>, "Callable must be nothrow move constructible");
+
+            reset();
+            ::new (&storage) callable_type(std::forward<Func>(func));
+            ops = &table<callable_type>;
+        }
+
+        /**
+         * @brief Resets a delegate.
+         *
+         * After a reset, a delegate cannot be invoked anymore.
+         */
+        void reset() noexcept
+        {
+            if (ops)
+            {
+                if (ops->destroy)
+                {
+                    ops->destroy(&storage);
+                }
+
+                ops = nullptr;
+            }
+        }
+
+        /**
+         * @brief Triggers a delegate.
+         *
+         * @warning
+         * Attempting to trigger an invalid delegate results in undefined
+         * behavior.
+         *
+         * @param args Arguments to use to invoke the underlying function.
+         * @return The value returned by the underlying function.
+         */
+        Ret operator()(Args... args) const
+        {
+            FSM_ASSERT(static_cast<bool>(*this), "Uninitialized delegate");
+            return ops->invoke(&storage, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Checks whether a delegate actually stores a callable.
+         * @return False if the delegate is empty, true otherwise.
+         */
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return ops != nullptr;
+        }
+
+    private:
+        // mutable as for std::function, a const delegate invokes a non-const callable
+        alignas(Align) mutable unsigned char storage[Size];
+        const operations *ops;
+    };
+
+} // namespace escad
@@ -0,0 +1,665 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/assert.h"
+#include "../base/compressed_pair.h"
+#include "../base/forwards.h"
+#include "../base/type_info.h"
+#include "../base/utils.h"
+#include "../container/dense_map.h"
+#include "forwards.h"
+#include "signal.h"
+
+namespace escad {
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+struct ordered_record {
+  // the rest of the buffer is unused, the next record is at its beginning
+  static constexpr std::uint32_t wrap = ~std::uint32_t{};
+  // the event has been discarded, the record is skipped
+  static constexpr std::uint32_t discarded = wrap - 1u;
+
+  std::uint32_t index;
+  std::uint32_t size;
+};
+
+struct basic_ordered_dispatcher_handler {
+  basic_ordered_dispatcher_handler(std::size_t size, std::size_t align,
+                                   std::uint32_t idx) noexcept
+      : event_size{size}, event_align{align}, index{idx}, pending{} {}
+
+  virtual ~basic_ordered_dispatcher_handler() = default;
+  virtual void publish(void *) = 0;
+  virtual void relocate(void *, void *) noexcept = 0;
+  virtual void destroy(void *) noexcept = 0;
+  virtual void disconnect(void *) = 0;
+
+  const std::size_t event_size;
+  const std::size_t event_align;
+  const std::uint32_t index;
+  std::size_t pending;
+};
+
+template <typename Type, typename Allocator>
+class ordered_dispatcher_handler final
+    : public basic_ordered_dispatcher_handler {
+  static_assert(std::is_same_v<Type, std::decay_t<Type>>, "Invalid type");
+  static_assert(std::is_nothrow_move_constructible_v<Type>,
+                "Events must be nothrow move constructible");
+  static_assert(alignof(Type) <= alignof(std::max_align_t),
+                "Over-aligned events aren't supported");
+
+  using signal_type = signal<void(Type &), Allocator>;
+
+ public:
+  using allocator_type = Allocator;
+
+  ordered_dispatcher_handler(std::uint32_t idx, const allocator_type &allocator)
+      : basic_ordered_dispatcher_handler{sizeof(Type), alignof(Type), idx},
+        signal_{allocator} {}
+
+  void publish(void *value) override {
+    signal_.publish(*static_cast<Type *>(value));
+  }
+
+  void relocate(void *to, void *from) noexcept override {
+    auto *elem = static_cast<Type *>(from);
+    ::new (to) Type(std::move(*elem));
+    elem->~Type();
+  }
+
+  void destroy(void *value) noexcept override {
+    static_cast<Type *>(value)->~Type();
+  }
+
+  void disconnect(void *instance) override { bucket().disconnect(instance); }
+
+  [[nodiscard]] auto bucket() noexcept {
+    return typename signal_type::slot_type{signal_};
+  }
+
+  void trigger(Type event) { signal_.publish(event); }
+
+  template <typename... Args>
+  static void construct(void *at, Args &&...args) {
+    if constexpr (std::is_aggregate_v<Type>) {
+      ::new (at) Type{std::forward<Args>(args)...};
+    } else {
+      ::new (at) Type(std::forward<Args>(args)...);
+    }
+  }
+
+ private:
+  signal_type signal_;
+};
+
+}  // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+/**
+ * @brief Dispatcher which delivers queued events in enqueue order.
+ *
+ * The interface follows the one of basic_dispatcher. The difference is that
+ * all the queues share a single ring buffer, so that `update` delivers the
+ * events of all types strictly in the order in which they were enqueued.<br/>
+ * Every record in the buffer is a small header (index of the queue and size
+ * of the record) followed by the event constructed in place. Enqueuing never
+ * allocates unless the buffer has to grow, in which case the pending events
+ * are moved into a larger buffer.
+ *
+ * Events enqueued while delivering are left for the next update. Events must
+ * be nothrow move constructible and must not be over-aligned.
+ *
+ * @tparam Allocator Type of allocator used to manage memory and elements.
+ */
+template <typename Allocator>
+class basic_ordered_dispatcher {
+  template <typename Type>
+  using handler_type = details::ordered_dispatcher_handler<Type, Allocator>;
+
+  using record_type = details::ordered_record;
+  using base_handler_type = details::basic_ordered_dispatcher_handler;
+
+  using key_type = escad::id_type;
+  // std::shared_ptr because of its type erased allocator which is pretty useful
+  // here
+  using mapped_type = std::shared_ptr<base_handler_type>;
+
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using container_allocator = typename alloc_traits::template rebind_alloc<
+      std::pair<const key_type, mapped_type>>;
+  using container_type =
+      escad::dense_map<key_type, mapped_type, escad::identity,
+                       std::equal_to<key_type>, container_allocator>;
+  using index_type =
+      std::vector<base_handler_type *, typename alloc_traits::template rebind_alloc<
+                                           base_handler_type *>>;
+
+  using block_type = std::max_align_t;
+  using block_traits =
+      typename alloc_traits::template rebind_traits<block_type>;
+  using block_allocator = typename block_traits::allocator_type;
+
+  static constexpr std::size_t granularity = alignof(record_type);
+  static constexpr std::size_t min_capacity = 256u;
+
+  [[nodiscard]] static constexpr std::size_t align_up(
+      const std::size_t value, const std::size_t align) noexcept {
+    return (value + align - 1u) & ~(align - 1u);
+  }
+
+  [[nodiscard]] static std::size_t event_offset(
+      const std::size_t pos, const base_handler_type &handler) noexcept {
+    return align_up(pos + sizeof(record_type), handler.event_align);
+  }
+
+  [[nodiscard]] static std::size_t record_size(
+      const std::size_t pos, const base_handler_type &handler) noexcept {
+    return align_up(event_offset(pos, handler) + handler.event_size,
+                    granularity) -
+           pos;
+  }
+
+  [[nodiscard]] record_type &record_at(const std::size_t pos) const noexcept {
+    return *std::launder(reinterpret_cast<record_type *>(data + pos));
+  }
+
+  [[nodiscard]] void *event_at(const std::size_t pos,
+                               const base_handler_type &handler) const noexcept {
+    return data + event_offset(pos, handler);
+  }
+
+  // the rest of the buffer is unused, either it's too short for a header or
+  // it starts with a wrap record
+  [[nodiscard]] bool wraps_at(const std::size_t pos) const noexcept {
+    return capacity - pos < sizeof(record_type) ||
+           record_at(pos).index == record_type::wrap;
+  }
+
+  template <typename Type>
+  [[nodiscard]] handler_type<Type> &assure(const escad::id_type id) {
+    static_assert(std::is_same_v<Type, std::decay_t<Type>>,
+                  "Non-decayed types not allowed");
+    auto &&ptr = pools.first()[id];
+
+    if (!ptr) {
+      const auto &allocator = pools.second();
+      const auto idx = static_cast<std::uint32_t>(handlers.size());
+      FSM_ASSERT(idx < record_type::discarded, "Too many queues");
+      handlers.reserve(handlers.size() + 1u);
+      ptr = std::allocate_shared<handler_type<Type>>(allocator, idx, allocator);
+      handlers.push_back(ptr.get());
+    }
+
+    return static_cast<handler_type<Type> &>(*ptr);
+  }
+
+  // visits the live records in order, func(pos, record)
+  template <typename Func>
+  void each(Func func) {
+    auto pos = read;
+
+    for (auto count = records; count;) {
+      if (wraps_at(pos)) {
+        pos = 0u;
+        continue;
+      }
+
+      auto &record = record_at(pos);
+      const auto size = record.size;
+
+      if (record.index != record_type::discarded) {
+        func(pos, record);
+        --count;
+      }
+
+      pos += size;
+    }
+  }
+
+  [[nodiscard]] record_type &next_record() noexcept {
+    for (;;) {
+      if (wraps_at(read)) {
+        used -= capacity - read;
+        read = 0u;
+        continue;
+      }
+
+      auto &record = record_at(read);
+
+      if (record.index == record_type::discarded) {
+        used -= record.size;
+        read += record.size;
+      } else {
+        return record;
+      }
+    }
+  }
+
+  [[nodiscard]] static std::size_t max_record_size(
+      const base_handler_type &handler) noexcept {
+    return sizeof(record_type) + handler.event_align + handler.event_size +
+           granularity;
+  }
+
+  void grow(const std::size_t extra) {
+    const auto required = used - (pinned ? flight_size : 0u) + extra;
+    auto cap = capacity ? capacity * 2u : min_capacity;
+
+    while (cap < required) {
+      cap *= 2u;
+    }
+
+    block_allocator allocator{pools.second()};
+    auto *mem = reinterpret_cast<std::byte *>(
+        block_traits::allocate(allocator, cap / sizeof(block_type)));
+    std::size_t pos{};
+
+    each([&](const std::size_t from, const record_type &record) {
+      auto &owner = *handlers[record.index];
+      const auto size = record_size(pos, owner);
+      ::new (mem + pos) record_type{record.index, static_cast<std::uint32_t>(size)};
+      owner.relocate(mem + event_offset(pos, owner), event_at(from, owner));
+      pos += size;
+    });
+
+    if (pinned) {
+      // the event being delivered stays where it is until it's destroyed
+      retired = data;
+      retired_capacity = capacity;
+      pinned = false;
+    } else {
+      release(data, capacity);
+    }
+
+    data = mem;
+    capacity = cap;
+    read = 0u;
+    write = pos;
+    used = pos;
+  }
+
+  void release(std::byte *mem, const std::size_t cap) noexcept {
+    if (mem) {
+      block_allocator allocator{pools.second()};
+      block_traits::deallocate(allocator, reinterpret_cast<block_type *>(mem),
+                               cap / sizeof(block_type));
+    }
+  }
+
+  // returns the position of a record for the given queue, grows if required
+  [[nodiscard]] std::size_t reserve(const base_handler_type &handler) {
+    if (used == 0u) {
+      read = write = 0u;
+    }
+
+    const auto first = pinned ? flight_start : read;
+
+    if (used != 0u && write <= first) {
+      if (write + record_size(write, handler) <= first) {
+        return write;
+      }
+    } else if (write + record_size(write, handler) <= capacity) {
+      return write;
+    } else if (capacity && record_size(0u, handler) <= first) {
+      // a tail too short for a header wraps without a record
+      if (capacity - write >= sizeof(record_type)) {
+        ::new (data + write) record_type{
+            record_type::wrap, static_cast<std::uint32_t>(capacity - write)};
+      }
+
+      used += capacity - write;
+      write = 0u;
+      return write;
+    }
+
+    grow(max_record_size(handler));
+    return write;
+  }
+
+  void destroy_all() noexcept {
+    each([this](const std::size_t pos, record_type &record) {
+      auto &owner = *handlers[record.index];
+      owner.destroy(event_at(pos, owner));
+    });
+
+    for (auto *handler : handlers) {
+      handler->pending = 0u;
+    }
+
+    records = 0u;
+    remaining = 0u;
+  }
+
+ public:
+  /*! @brief Allocator type. */
+  using allocator_type = Allocator;
+  /*! @brief Unsigned integer type. */
+  using size_type = std::size_t;
+
+  /*! @brief Default constructor. */
+  basic_ordered_dispatcher() : basic_ordered_dispatcher{allocator_type{}} {}
+
+  /**
+   * @brief Constructs a dispatcher with a given allocator.
+   * @param allocator The allocator to use.
+   */
+  explicit basic_ordered_dispatcher(const allocator_type &allocator)
+      : pools{allocator, allocator},
+        handlers{allocator},
+        data{},
+        retired{},
+        capacity{},
+        retired_capacity{},
+        read{},
+        write{},
+        used{},
+        records{},
+        remaining{},
+        flight_start{},
+        flight_size{},
+        pinned{},
+        delivering{} {}
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  basic_ordered_dispatcher(const basic_ordered_dispatcher &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This dispatcher.
+   */
+  basic_ordered_dispatcher &operator=(const basic_ordered_dispatcher &) =
+      delete;
+
+  /*! @brief Destroys the pending events. */
+  ~basic_ordered_dispatcher() {
+    destroy_all();
+    release(data, capacity);
+  }
+
+  /**
+   * @brief Returns the associated allocator.
+   * @return The associated allocator.
+   */
+  [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
+    return pools.second();
+  }
+
+  /**
+   * @brief Returns the number of pending events for a given type.
+   * @tparam Type Type of event for which to return the count.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return The number of pending events for the given type.
+   */
+  template <typename Type>
+  size_type size(
+      const escad::id_type id = escad::type_hash<Type>::value()) const noexcept {
+    if (auto it = pools.first().find(id); it != pools.first().cend()) {
+      return it->second->pending;
+    }
+
+    return 0u;
+  }
+
+  /**
+   * @brief Returns the total number of pending events.
+   * @return The total number of pending events.
+   */
+  size_type size() const noexcept { return records; }
+
+  /**
+   * @brief Returns the number of bytes the events can occupy without
+   * growing the buffer.
+   * @return Capacity of the buffer in bytes.
+   */
+  size_type capacity_bytes() const noexcept { return capacity; }
+
+  /**
+   * @brief Increases the capacity of the buffer.
+   * @param cap Desired capacity in bytes.
+   */
+  void reserve_bytes(const size_type cap) {
+    if (cap > capacity) {
+      grow(cap - used);
+    }
+  }
+
+  /**
+   * @brief Returns a sink object for the given event and queue.
+   * @sa basic_dispatcher::slot
+   * @tparam Type Type of event of which to get the sink.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @return A temporary sink object.
+   */
+  template <typename Type>
+  [[nodiscard]] auto slot(
+      const escad::id_type id = escad::type_hash<Type>::value()) {
+    return assure<Type>(id).bucket();
+  }
+
+  /**
+   * @brief Triggers an immediate event of a given type.
+   * @tparam Type Type of event to trigger.
+   * @param value An instance of the given type of event.
+   */
+  template <typename Type>
+  void trigger(Type &&value = {}) {
+    trigger(escad::type_hash<std::decay_t<Type>>::value(),
+            std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Triggers an immediate event on a queue of a given type.
+   * @tparam Type Type of event to trigger.
+   * @param value An instance of the given type of event.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void trigger(const escad::id_type id, Type &&value = {}) {
+    assure<std::decay_t<Type>>(id).trigger(std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @tparam Args Types of arguments to use to construct the event.
+   * @param args Arguments to use to construct the event.
+   */
+  template <typename Type, typename... Args>
+  void enqueue(Args &&...args) {
+    enqueue_hint<Type>(escad::type_hash<Type>::value(),
+                       std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @param value An instance of the given type of event.
+   */
+  template <typename Type>
+  void enqueue(Type &&value) {
+    enqueue_hint(escad::type_hash<std::decay_t<Type>>::value(),
+                 std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @tparam Args Types of arguments to use to construct the event.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @param args Arguments to use to construct the event.
+   */
+  template <typename Type, typename... Args>
+  void enqueue_hint(const escad::id_type id, Args &&...args) {
+    auto &handler = assure<Type>(id);
+    const auto pos = reserve(handler);
+    const auto size = record_size(pos, handler);
+
+    handler_type<Type>::construct(event_at(pos, handler),
+                                  std::forward<Args>(args)...);
+    ::new (data + pos)
+        record_type{handler.index, static_cast<std::uint32_t>(size)};
+
+    write = pos + size;
+    used += size;
+    ++records;
+    ++handler.pending;
+  }
+
+  /**
+   * @brief Enqueues an event of the given type.
+   * @tparam Type Type of event to enqueue.
+   * @param id Name used to map the event queue within the dispatcher.
+   * @param value An instance of the given type of event.
+   */
+  template <typename Type>
+  void enqueue_hint(const escad::id_type id, Type &&value) {
+    enqueue_hint<std::decay_t<Type>, Type>(id, std::forward<Type>(value));
+  }
+
+  /**
+   * @brief Utility function to disconnect everything related to a given value
+   * or instance from a dispatcher.
+   * @tparam Type Type of class or type of payload.
+   * @param value_or_instance A valid object that fits the purpose.
+   */
+  template <typename Type>
+  void disconnect(Type &value_or_instance) {
+    disconnect(&value_or_instance);
+  }
+
+  /**
+   * @brief Utility function to disconnect everything related to a given value
+   * or instance from a dispatcher.
+   * @tparam Type Type of class or type of payload.
+   * @param value_or_instance A valid object that fits the purpose.
+   */
+  template <typename Type>
+  void disconnect(Type *value_or_instance) {
+    for (auto *handler : handlers) {
+      handler->disconnect(value_or_instance);
+    }
+  }
+
+  /**
+   * @brief Discards all the events stored so far in a given queue.
+   *
+   * The records of the discarded events are skipped by the next update.
+   *
+   * @tparam Type Type of event to discard.
+   * @param id Name used to map the event queue within the dispatcher.
+   */
+  template <typename Type>
+  void clear(const escad::id_type id = escad::type_hash<Type>::value()) {
+    auto &handler = assure<Type>(id);
+
+    if (handler.pending) {
+      std::size_t visited{};
+
+      each([this, &handler, &visited](const std::size_t pos,
+                                      record_type &record) {
+        if (record.index == handler.index) {
+          handler.destroy(event_at(pos, handler));
+          record.index = record_type::discarded;
+          --records;
+
+          // the event was due in the ongoing update, if any, the record
+          // being delivered is no longer counted
+          if (visited < remaining) {
+            --remaining;
+          }
+        } else {
+          ++visited;
+        }
+      });
+
+      handler.pending = 0u;
+    }
+  }
+
+  /*! @brief Discards all the events queued so far. */
+  void clear() noexcept {
+    destroy_all();
+
+    if (pinned) {
+      read = write = flight_start + flight_size;
+      used = flight_size;
+    } else {
+      read = write = used = 0u;
+    }
+  }
+
+  /**
+   * @brief Delivers all the pending events in enqueue order.
+   *
+   * Events enqueued while delivering are left for the next update.
+   */
+  void update() {
+    FSM_ASSERT(!delivering, "Recursive update");
+    delivering = true;
+
+    // listeners may clear the queues, so that nothing is left to deliver
+    for (remaining = records; remaining;) {
+      --remaining;
+      auto &record = next_record();
+      auto &handler = *handlers[record.index];
+      void *event = event_at(read, handler);
+
+      flight_start = read;
+      flight_size = record.size;
+      pinned = true;
+      read += record.size;
+      --records;
+      --handler.pending;
+
+      handler.publish(event);
+      handler.destroy(event);
+
+      if (pinned) {
+        pinned = false;
+        used -= flight_size;
+      } else {
+        release(std::exchange(retired, nullptr), retired_capacity);
+      }
+    }
+
+    delivering = false;
+  }
+
+ private:
+  escad::compressed_pair<container_type, allocator_type> pools;
+  index_type handlers;
+  std::byte *data;
+  std::byte *retired;
+  size_type capacity;
+  size_type retired_capacity;
+  size_type read;
+  size_type write;
+  size_type used;
+  size_type records;
+  size_type remaining;
+  size_type flight_start;
+  size_type flight_size;
+  bool pinned;
+  bool delivering;
+};
+
+}  // namespace escad
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "../base/assert.h"
+#include "../container/dense_map.h"
+#include "delegate.h"
+#include "inplace_delegate.h"
+
+namespace escad {
+
+/**
+ * @cond TURN_OFF_DOXYGEN
+ * Internal details not to be documented.
+ */
+
+namespace details {
+
+template <typename, typename = void>
+struct has_budgeted_update : std::false_type {};
+
+template <typename Dispatcher>
+struct has_budgeted_update<
+    Dispatcher,
+    std::void_t<decltype(std::declval<Dispatcher &>().update(std::size_t{}))>>
+    : std::true_type {};
+
+}  // namespace details
+
+/**
+ * Internal details not to be documented.
+ * @endcond
+ */
+
+/**
+ * @brief Wake-up source backed by a Linux eventfd.
+ *
+ * Meant to be used as the notifier of a dispatcher, so that a consumer can
+ * wait for events with `epoll`, `poll` or `select` along with its other file
+ * descriptors. The descriptor is non-blocking and becomes readable once
+ * `notify` is called, until `consume` is called.
+ *
+ * Notifying is thread safe and async signal safe.
+ */
+class eventfd_notifier {
+ public:
+  /*! @brief Creates the underlying eventfd. */
+  eventfd_notifier() noexcept : fd_{::eventfd(0u, EFD_NONBLOCK | EFD_CLOEXEC)} {}
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  eventfd_notifier(const eventfd_notifier &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This notifier.
+   */
+  eventfd_notifier &operator=(const eventfd_notifier &) = delete;
+
+  /*! @brief Closes the underlying eventfd. */
+  ~eventfd_notifier() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  /**
+   * @brief Checks whether the eventfd could be created.
+   * @return True if the notifier is usable, false otherwise.
+   */
+  [[nodiscard]] explicit operator bool() const noexcept { return fd_ >= 0; }
+
+  /**
+   * @brief Returns the file descriptor to wait for.
+   * @return The underlying file descriptor.
+   */
+  [[nodiscard]] int handle() const noexcept { return fd_; }
+
+  /*! @brief Makes the file descriptor readable. */
+  void notify() const noexcept {
+    const std::uint64_t value{1u};
+    // fails only if the counter is about to overflow, it's readable anyway
+    [[maybe_unused]] const auto ret = ::write(fd_, &value, sizeof(value));
+  }
+
+  /**
+   * @brief Resets the file descriptor to not readable.
+   * @return True if the notifier had been notified, false otherwise.
+   */
+  bool consume() const noexcept {
+    std::uint64_t value{};
+    return ::read(fd_, &value, sizeof(value)) == sizeof(value);
+  }
+
+ private:
+  int fd_;
+};
+
+/**
+ * @brief Minimal epoll loop which drains a dispatcher.
+ *
+ * The reactor installs an eventfd_notifier as the notifier of the dispatcher
+ * and waits for it along with the file descriptors registered with `watch`.
+ * Whenever events are pending, they are delivered with a budgeted update if
+ * the dispatcher offers one, so that a flood of events cannot starve the file
+ * descriptors. A consumer that is idle sleeps in `epoll_wait` and wakes up as
+ * soon as an event is enqueued:
+ *
+ * @code{.cpp}
+ * escad::concurrent_dispatcher dispatcher;
+ * escad::reactor reactor{dispatcher};
+ * dispatcher.prepare<my_event>();
+ * dispatcher.freeze();
+ * // producers can start, the current thread becomes the consumer
+ * reactor.run();
+ * @endcode
+ *
+ * The dispatcher must outlive the reactor. Neither is meant to be moved while
+ * the other is alive.
+ *
+ * @tparam Dispatcher Type of dispatcher to drain.
+ */
+template <typename Dispatcher>
+class reactor {
+  // epoll data of the notifier, never a valid file descriptor
+  static constexpr std::uint64_t wakeup_tag = ~std::uint64_t{};
+
+ public:
+  /*! @brief Unsigned integer type. */
+  using size_type = std::size_t;
+  /*! @brief Callback invoked with the readiness flags of a descriptor. */
+  using callback_type = inplace_delegate<void(std::uint32_t)>;
+
+  /*! @brief Default number of events delivered per iteration. */
+  static constexpr size_type default_budget = 256u;
+
+  /**
+   * @brief Constructs a reactor for a given dispatcher.
+   * @param dispatcher The dispatcher to drain.
+   * @param budget Maximum number of events delivered per iteration.
+   */
+  explicit reactor(Dispatcher &dispatcher,
+                   const size_type budget = default_budget)
+      : dispatcher_{&dispatcher},
+        wakeup_{},
+        callbacks_{},
+        budget_{budget},
+        epoll_{::epoll_create1(EPOLL_CLOEXEC)},
+        stopped_{false} {
+    FSM_ASSERT(budget_ != 0u, "Invalid budget");
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = wakeup_tag;
+
+    if (!wakeup_ || epoll_ < 0 ||
+        ::epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_.handle(), &event) != 0) {
+      FSM_ASSERT(false, "Unable to set up the reactor");
+    } else {
+      dispatcher_->notifier(
+          {connect_arg<&eventfd_notifier::notify>, wakeup_});
+    }
+  }
+
+  /*! @brief Default copy constructor, deleted on purpose. */
+  reactor(const reactor &) = delete;
+
+  /**
+   * @brief Default copy assignment operator, deleted on purpose.
+   * @return This reactor.
+   */
+  reactor &operator=(const reactor &) = delete;
+
+  /*! @brief Detaches the reactor from its dispatcher. */
+  ~reactor() {
+    dispatcher_->notifier({});
+
+    if (epoll_ >= 0) {
+      ::close(epoll_);
+    }
+  }
+
+  /**
+   * @brief Registers a file descriptor with the reactor.
+   *
+   * The callback is invoked on the thread running the reactor, with the epoll
+   * flags reported for the descriptor. It can unwatch its own descriptor.
+   *
+   * @param fd File descriptor to watch.
+   * @param events Epoll flags to wait for, e.g. `EPOLLIN`.
+   * @param callback Function to invoke when the descriptor is ready.
+   * @return True if the descriptor has been registered, false otherwise.
+   */
+  bool watch(const int fd, const std::uint32_t events, callback_type callback) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = static_cast<std::uint32_t>(fd);
+
+    if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      return false;
+    }
+
+    callbacks_.insert_or_assign(fd, std::move(callback));
+    return true;
+  }
+
+  /**
+   * @brief Unregisters a file descriptor.
+   *
+   * Descriptors must be unwatched before they are closed.
+   *
+   * @param fd File descriptor to stop watching.
+   * @return True if the descriptor was registered, false otherwise.
+   */
+  bool unwatch(const int fd) {
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    return callbacks_.erase(fd) != 0u;
+  }
+
+  /**
+   * @brief Waits once for readiness and delivers the pending events.
+   *
+   * The call returns immediately if events are pending already.
+   *
+   * @param timeout Maximum time to wait in milliseconds, -1 to wait forever.
+   * @return The number of events still pending.
+   */
+  size_type poll(const int timeout = -1) {
+    epoll_event ready[batch_size];
+    const auto count = ::epoll_wait(epoll_, ready, batch_size, timeout);
+
+    for (int pos{}; pos < count; ++pos) {
+      if (ready[pos].data.u64 == wakeup_tag) {
+        wakeup_.consume();
+      } else {
+        dispatch(static_cast<int>(ready[pos].data.u64), ready[pos].events);
+      }
+    }
+
+    return drain();
+  }
+
+  /**
+   * @brief Runs the loop until stopped.
+   *
+   * The flag set by `stop` is cleared on return, so that the loop can run
+   * again.
+   */
+  void run() {
+    while (!stopped_.load(std::memory_order_acquire)) {
+      poll();
+    }
+
+    stopped_.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Makes `run` return after the current iteration.
+   *
+   * Thread safe, `run` is woken up if it's waiting.
+   */
+  void stop() noexcept {
+    stopped_.store(true, std::memory_order_release);
+    wakeup_.notify();
+  }
+
+  /**
+   * @brief Returns the epoll descriptor of the reactor.
+   *
+   * The descriptor is readable whenever the reactor has work to do, so that
+   * reactors can be nested in other event loops.
+   *
+   * @return The underlying epoll descriptor.
+   */
+  [[nodiscard]] int handle() const noexcept { return epoll_; }
+
+ private:
+  static constexpr int batch_size = 64;
+
+  void dispatch(const int fd, const std::uint32_t events) {
+    if (auto it = callbacks_.find(fd); it != callbacks_.end()) {
+      // moved out, the callback can unwatch and destroy its own slot
+      auto callback = std::move(it->second);
+      callback(events);
+
+      if (it = callbacks_.find(fd); it != callbacks_.end() && !it->second) {
+        it->second = std::move(callback);
+      }
+    }
+  }
+
+  size_type drain() {
+    if constexpr (details::has_budgeted_update<Dispatcher>::value) {
+      return dispatcher_->update(budget_);
+    } else {
+      dispatcher_->update();
+      return dispatcher_->size();
+    }
+  }
+
+ private:
+  Dispatcher *dispatcher_;
+  eventfd_notifier wakeup_;
+  dense_map<int, callback_type> callbacks_;
+  size_type budget_;
+  int epoll_;
+  std::atomic<bool> stopped_;
+};
+
+}  // namespace escad
@@ -11,11 +11,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include "../container/small_vector.h"
 #include "delegate.h"
 #include "forwards.h"
 
@@ -40,10 +45,27 @@ namespace escad
      *
      * @tparam Type A valid function type.
      * @tparam Allocator Type of allocator used to manage memory and elements.
+     * @tparam InlineSize Number of listeners stored without allocating.
      */
-    template <typename Type, typename Allocator>
+    template <typename Type, typename Allocator, std::size_t InlineSize>
     class signal;
 
+    /**
+     * @cond TURN_OFF_DOXYGEN
+     * Internal details not to be documented.
+     */
+
+    namespace details
+    {
+        template <typename Type, typename Allocator, std::size_t InlineSize>
+        using signal_container = std::conditional_t<InlineSize == 0u, std::vector<Type, Allocator>, small_vector<Type, InlineSize, Allocator>>;
+    } // namespace details
+
+    /**
+     * Internal details not to be documented.
+     * @endcond
+     */
+
     /**
      * @brief Unmanaged signal handler.
      *
@@ -56,18 +78,190 @@ namespace escad
      * * Creating signals to use later to notify a bunch of listeners.
      * * Collecting results from a set of functions like in a voting system.
      *
+     * Listeners are stored in a dense array in the order of their connection.
+     * Every listener is also given a generational key, which is what a
+     * connection object refers to. Releasing a connection is a constant time
+     * operation. It leaves a hole in the dense array that is skipped while
+     * publishing and compacted as soon as holes make up half of the array.
+     *
+     * With a non-zero `InlineSize` the first listeners are stored within the
+     * signal itself and the allocator is used only beyond that, see
+     * small_signal.
+     *
      * @tparam Ret Return type of a function type.
      * @tparam Args Types of arguments of a function type.
      * @tparam Allocator Type of allocator used to manage memory and elements.
+     * @tparam InlineSize Number of listeners stored without allocating.
      */
-    template <typename Ret, typename... Args, typename Allocator>
-    class signal<Ret(Args...), Allocator>
+    template <typename Ret, typename... Args, typename Allocator, std::size_t InlineSize>
+    class signal<Ret(Args...), Allocator, InlineSize>
     {
         /*! @brief A slot is allowed to modify a signal. */
-        friend class slot<signal<Ret(Args...), Allocator>>;
+        friend class slot<signal<Ret(Args...), Allocator, InlineSize>>;
 
         using alloc_traits = std::allocator_traits<Allocator>;
-        using container_type = std::vector<delegate<Ret(Args...)>, typename alloc_traits::template rebind_alloc<delegate<Ret(Args...)>>>;
+        static constexpr std::uint32_t null_key = ~std::uint32_t{};
+
+        struct entry
+        {
+            // listener at this position of the dense array and its key
+            delegate<Ret(Args...)> call{};
+            std::uint32_t handle{null_key};
+            // key with this index, its position in the dense array or the next
+            // free key
+            std::uint32_t dense{};
+            std::uint32_t generation{};
+        };
+
+        using container_type = details::signal_container<entry, typename alloc_traits::template rebind_alloc<entry>, InlineSize>;
+
+        // the key table shares the entries with the dense array, it can be the
+        // longer of the two after a compaction
+        entry &reserve_entry(const std::size_t pos)
+        {
+            if (pos == entries.size())
+            {
+                entries.emplace_back();
+            }
+
+            return entries[pos];
+        }
+
+        std::uint64_t acquire_key(const std::size_t pos)
+        {
+            std::uint32_t index = free_key;
+
+            if (index == null_key)
+            {
+                index = keys++;
+                reserve_entry(index);
+            }
+            else
+            {
+                free_key = entries[index].dense;
+            }
+
+            entries[index].dense = static_cast<std::uint32_t>(pos);
+            return (static_cast<std::uint64_t>(entries[index].generation) << 32u) | index;
+        }
+
+        void release_key(const std::uint32_t index) noexcept
+        {
+            ++entries[index].generation;
+            entries[index].dense = std::exchange(free_key, index);
+        }
+
+        void move_listener(const std::size_t from, const std::size_t to) noexcept
+        {
+            const auto handle = entries[from].handle;
+            entries[to].call = entries[from].call;
+            entries[to].handle = handle;
+
+            if (handle != null_key)
+            {
+                entries[handle].dense = static_cast<std::uint32_t>(to);
+            }
+        }
+
+        std::uint64_t insert(const std::size_t pos, delegate<Ret(Args...)> call)
+        {
+            reserve_entry(count);
+
+            for (auto next = count; next > pos; --next)
+            {
+                move_listener(next - 1u, next);
+            }
+
+            ++count;
+            const auto key = acquire_key(pos);
+            entries[pos].call = std::move(call);
+            entries[pos].handle = static_cast<std::uint32_t>(key);
+            return key;
+        }
+
+        void erase(const std::uint64_t key) noexcept
+        {
+            const auto index = static_cast<std::uint32_t>(key);
+
+            if (index < keys && entries[index].generation == static_cast<std::uint32_t>(key >> 32u))
+            {
+                const auto pos = entries[index].dense;
+                entries[pos].call.reset();
+                entries[pos].handle = null_key;
+                release_key(index);
+
+                if (++tombstones > count / 2u)
+                {
+                    compact([](const auto &)
+                            { return false; },
+                            true);
+                }
+            }
+        }
+
+        template <typename Func>
+        void compact(Func func, const bool drop_tombstones) noexcept
+        {
+            std::size_t next{};
+
+            for (std::size_t pos{}; pos < count; ++pos)
+            {
+                const auto handle = entries[pos].handle;
+
+                if (handle == null_key)
+                {
+                    if (drop_tombstones)
+                    {
+                        continue;
+                    }
+                }
+                else if (func(std::as_const(entries[pos].call)))
+                {
+                    release_key(handle);
+                    continue;
+                }
+
+                move_listener(pos, next++);
+            }
+
+            if (drop_tombstones)
+            {
+                tombstones = 0u;
+            }
+
+            truncate(next);
+        }
+
+        void truncate(const std::size_t size) noexcept
+        {
+            for (auto pos = size; pos < count; ++pos)
+            {
+                entries[pos].call.reset();
+                entries[pos].handle = null_key;
+            }
+
+            count = size;
+        }
+
+        void clear() noexcept
+        {
+            for (std::size_t pos{}; pos < count; ++pos)
+            {
+                if (entries[pos].handle != null_key)
+                {
+                    release_key(entries[pos].handle);
+                }
+            }
+
+            truncate(0u);
+            tombstones = 0u;
+        }
+
+        [[nodiscard]] auto listeners() const noexcept
+        {
+            const auto first = entries.cbegin();
+            return std::make_pair(first, first + static_cast<typename container_type::difference_type>(count));
+        }
 
     public:
         /*! @brief Allocator type. */
@@ -75,7 +269,7 @@ namespace escad
         /*! @brief Unsigned integer type. */
         using size_type = std::size_t;
         /*! @brief Slot type. */
-        using slot_type = slot<signal<Ret(Args...), Allocator>>;
+        using slot_type = slot<signal<Ret(Args...), Allocator, InlineSize>>;
 
         /*! @brief Default constructor. */
         signal() noexcept(std::is_nothrow_default_constructible_v<allocator_type> &&std::is_nothrow_constructible_v<container_type, const allocator_type &>)
@@ -86,14 +280,18 @@ namespace escad
          * @param allocator The allocator to use.
          */
         explicit signal(const allocator_type &allocator) noexcept(std::is_nothrow_constructible_v<container_type, const allocator_type &>)
-            : calls{allocator} {}
+            : entries{allocator} {}
 
         /**
          * @brief Copy constructor.
          * @param other The instance to copy from.
          */
         signal(const signal &other) noexcept(std::is_nothrow_copy_constructible_v<container_type>)
-            : calls{other.calls} {}
+            : entries{other.entries},
+              keys{other.keys},
+              free_key{other.free_key},
+              count{other.count},
+              tombstones{other.tombstones} {}
 
         /**
          * @brief Allocator-extended copy constructor.
@@ -101,14 +299,22 @@ namespace escad
          * @param allocator The allocator to use.
          */
         signal(const signal &other, const allocator_type &allocator) noexcept(std::is_nothrow_constructible_v<container_type, const container_type &, const allocator_type &>)
-            : calls{other.calls, allocator} {}
+            : entries{other.entries, allocator},
+              keys{other.keys},
+              free_key{other.free_key},
+              count{other.count},
+              tombstones{other.tombstones} {}
 
         /**
          * @brief Move constructor.
          * @param other The instance to move from.
          */
         signal(signal &&other) noexcept(std::is_nothrow_move_constructible_v<container_type>)
-            : calls{std::move(other.calls)} {}
+            : entries{std::move(other.entries)},
+              keys{std::exchange(other.keys, 0u)},
+              free_key{std::exchange(other.free_key, null_key)},
+              count{std::exchange(other.count, 0u)},
+              tombstones{std::exchange(other.tombstones, 0u)} {}
 
         /**
          * @brief Allocator-extended move constructor.
@@ -116,7 +322,11 @@ namespace escad
          * @param allocator The allocator to use.
          */
         signal(signal &&other, const allocator_type &allocator) noexcept(std::is_nothrow_constructible_v<container_type, container_type &&, const allocator_type &>)
-            : calls{std::move(other.calls), allocator} {}
+            : entries{std::move(other.entries), allocator},
+              keys{std::exchange(other.keys, 0u)},
+              free_key{std::exchange(other.free_key, null_key)},
+              count{std::exchange(other.count, 0u)},
+              tombstones{std::exchange(other.tombstones, 0u)} {}
 
         /**
          * @brief Copy assignment operator.
@@ -125,7 +335,11 @@ namespace escad
          */
         signal &operator=(const signal &other) noexcept(std::is_nothrow_copy_assignable_v<container_type>)
         {
-            calls = other.calls;
+            entries = other.entries;
+            keys = other.keys;
+            free_key = other.free_key;
+            count = other.count;
+            tombstones = other.tombstones;
             return *this;
         }
 
@@ -136,7 +350,11 @@ namespace escad
          */
         signal &operator=(signal &&other) noexcept(std::is_nothrow_move_assignable_v<container_type>)
         {
-            calls = std::move(other.calls);
+            entries = std::move(other.entries);
+            keys = std::exchange(other.keys, 0u);
+            free_key = std::exchange(other.free_key, null_key);
+            count = std::exchange(other.count, 0u);
+            tombstones = std::exchange(other.tombstones, 0u);
             return *this;
         }
 
@@ -147,7 +365,11 @@ namespace escad
         void swap(signal &other) noexcept(std::is_nothrow_swappable_v<container_type>)
         {
             using std::swap;
-            swap(calls, other.calls);
+            swap(entries, other.entries);
+            swap(keys, other.keys);
+            swap(free_key, other.free_key);
+            swap(count, other.count);
+            swap(tombstones, other.tombstones);
         }
 
         /**
@@ -156,7 +378,7 @@ namespace escad
          */
         [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
         {
-            return calls.get_allocator();
+            return entries.get_allocator();
         }
 
         /**
@@ -165,7 +387,7 @@ namespace escad
          */
         [[nodiscard]] size_type size() const noexcept
         {
-            return calls.size();
+            return count - tombstones;
         }
 
         /**
@@ -174,7 +396,7 @@ namespace escad
          */
         [[nodiscard]] bool empty() const noexcept
         {
-            return calls.empty();
+            return count == tombstones;
         }
 
         /**
@@ -186,9 +408,12 @@ namespace escad
          */
         void publish(Args... args) const
         {
-            for (auto &&call : std::as_const(calls))
+            for (auto [it, last] = listeners(); it != last; ++it)
             {
-                call(args...);
+                if (it->call)
+                {
+                    it->call(args...);
+                }
             }
         }
 
@@ -209,43 +434,144 @@ namespace escad
         template <typename Func>
         void collect(Func func, Args... args) const
         {
-            for (auto &&call : calls)
+            for (auto [it, last] = listeners(); it != last; ++it)
             {
-                if constexpr (std::is_void_v<Ret>)
+                if (it->call && invoke(func, it->call, args...))
                 {
-                    if constexpr (std::is_invocable_r_v<bool, Func>)
-                    {
-                        call(args...);
-                        if (func())
-                        {
-                            break;
-                        }
-                    }
-                    else
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief Triggers a signal once for every element of a range.
+         *
+         * Listeners are visited in the outer loop and elements in the inner
+         * one, so that a listener handles the whole batch before the next one
+         * is invoked. Elements are passed on as they are, they are copied only
+         * if the signal takes its argument by value.
+         *
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range.
+         * @param last An iterator past the last element of the range.
+         */
+        template <typename It>
+        void publish_batch(It first, It last) const
+        {
+            static_assert(sizeof...(Args) == 1u, "Batches require signals with a single argument");
+
+            for (auto [curr, past] = listeners(); curr != past; ++curr)
+            {
+                if (curr->call)
+                {
+                    // a local copy stays in registers across the opaque calls
+                    const auto listener = curr->call;
+
+                    for (auto it = first; it != last; ++it)
                     {
-                        call(args...);
-                        func();
+                        listener(*it);
                     }
                 }
-                else
+            }
+        }
+
+        /**
+         * @brief Triggers a signal once for every element of a range.
+         * @tparam Range Type of range, e.g. a vector or a span.
+         * @param range A range of elements.
+         */
+        template <typename Range>
+        void publish_batch(Range &&range) const
+        {
+            publish_batch(std::begin(range), std::end(range));
+        }
+
+        /**
+         * @brief Collects return values from the listeners for a batch of
+         * elements.
+         *
+         * Listeners and elements are visited as by `publish_batch`. The
+         * collector is the same as for `collect`, a true value stops the whole
+         * batch.
+         *
+         * @tparam Func Type of collector to use, if any.
+         * @tparam It Type of forward iterator.
+         * @param func A valid function object.
+         * @param first An iterator to the first element of the range.
+         * @param last An iterator past the last element of the range.
+         */
+        template <typename Func, typename It>
+        void collect_batch(Func func, It first, It last) const
+        {
+            static_assert(sizeof...(Args) == 1u, "Batches require signals with a single argument");
+
+            for (auto [curr, past] = listeners(); curr != past; ++curr)
+            {
+                if (curr->call)
                 {
-                    if constexpr (std::is_invocable_r_v<bool, Func, Ret>)
+                    for (auto it = first; it != last; ++it)
                     {
-                        if (func(call(args...)))
+                        if (invoke(func, curr->call, *it))
                         {
-                            break;
+                            return;
                         }
                     }
-                    else
-                    {
-                        func(call(args...));
-                    }
                 }
             }
         }
 
+        /**
+         * @brief Collects return values from the listeners for a batch of
+         * elements.
+         * @tparam Func Type of collector to use, if any.
+         * @tparam Range Type of range, e.g. a vector or a span.
+         * @param func A valid function object.
+         * @param range A range of elements.
+         */
+        template <typename Func, typename Range>
+        void collect_batch(Func func, Range &&range) const
+        {
+            collect_batch(std::move(func), std::begin(range), std::end(range));
+        }
+
     private:
-        container_type calls;
+        // true if the collector asks to stop
+        template <typename Func, typename... Params>
+        static bool invoke(Func &func, const delegate<Ret(Args...)> &call, Params &&...params)
+        {
+            if constexpr (std::is_void_v<Ret>)
+            {
+                call(std::forward<Params>(params)...);
+
+                if constexpr (std::is_invocable_r_v<bool, Func>)
+                {
+                    return func();
+                }
+                else
+                {
+                    func();
+                    return false;
+                }
+            }
+            else
+            {
+                if constexpr (std::is_invocable_r_v<bool, Func, Ret>)
+                {
+                    return func(call(std::forward<Params>(params)...));
+                }
+                else
+                {
+                    func(call(std::forward<Params>(params)...));
+                    return false;
+                }
+            }
+        }
+
+        container_type entries;
+        std::uint32_t keys{};
+        std::uint32_t free_key{null_key};
+        std::size_t count{};
+        std::size_t tombstones{};
     };
 
     /**
@@ -261,14 +587,15 @@ namespace escad
         template <typename>
         friend class slot;
 
-        connection(delegate<void(void *)> fn, void *ref)
-            : disconnect{fn}, signal{ref} {}
+        connection(delegate<void(void *, std::uint64_t)> fn, void *ref, std::uint64_t id = {})
+            : disconnect{fn}, signal{ref}, key{id} {}
 
     public:
         /*! @brief Default constructor. */
         connection()
             : disconnect{},
-              signal{} {}
+              signal{},
+              key{} {}
 
         /**
          * @brief Checks whether a connection is properly initialized.
@@ -284,14 +611,15 @@ namespace escad
         {
             if (disconnect)
             {
-                disconnect(signal);
+                disconnect(signal, key);
                 disconnect.reset();
             }
         }
 
     private:
-        delegate<void(void *)> disconnect;
+        delegate<void(void *, std::uint64_t)> disconnect;
         void *signal;
+        std::uint64_t key;
     };
 
     /**
@@ -396,23 +724,17 @@ namespace escad
      * @tparam Ret Return type of a function type.
      * @tparam Args Types of arguments of a function type.
      * @tparam Allocator Type of allocator used to manage memory and elements.
+     * @tparam InlineSize Number of listeners stored without allocating.
      */
-    template <typename Ret, typename... Args, typename Allocator>
-    class slot<signal<Ret(Args...), Allocator>>
+    template <typename Ret, typename... Args, typename Allocator, std::size_t InlineSize>
+    class slot<signal<Ret(Args...), Allocator, InlineSize>>
     {
-        using signal_type = signal<Ret(Args...), Allocator>;
+        using signal_type = signal<Ret(Args...), Allocator, InlineSize>;
         using difference_type = typename signal_type::container_type::difference_type;
 
-        template <auto Candidate, typename Type>
-        static void release(Type value_or_instance, void *signal)
+        static void release(void *signal, std::uint64_t key)
         {
-            slot{*static_cast<signal_type *>(signal)}.disconnect<Candidate>(value_or_instance);
-        }
-
-        template <auto Candidate>
-        static void release(void *signal)
-        {
-            slot{*static_cast<signal_type *>(signal)}.disconnect<Candidate>();
+            static_cast<signal_type *>(signal)->erase(key);
         }
 
     public:
@@ -420,7 +742,7 @@ namespace escad
          * @brief Constructs a slot that is allowed to modify a given signal.
          * @param ref A valid reference to a signal object.
          */
-        slot(signal<Ret(Args...), Allocator> &ref) noexcept
+        slot(signal<Ret(Args...), Allocator, InlineSize> &ref) noexcept
             : _offset{},
               _signal{&ref} {}
 
@@ -430,7 +752,7 @@ namespace escad
          */
         [[nodiscard]] bool empty() const noexcept
         {
-            return _signal->calls.empty();
+            return _signal->empty();
         }
 
         /**
@@ -445,11 +767,12 @@ namespace escad
             delegate<Ret(Args...)> call{};
             call.template connect<Function>();
 
-            const auto &calls = _signal->calls;
-            const auto it = std::find(calls.cbegin(), calls.cend(), std::move(call));
+            const auto [first, last] = _signal->listeners();
+            const auto it = std::find_if(first, last, [&call](const auto &elem)
+                                         { return elem.call == call; });
 
             slot other{*this};
-            other._offset = calls.cend() - it;
+            other._offset = last - it;
             return other;
         }
 
@@ -467,11 +790,12 @@ namespace escad
             delegate<Ret(Args...)> call{};
             call.template connect<Candidate>(value_or_instance);
 
-            const auto &calls = _signal->calls;
-            const auto it = std::find(calls.cbegin(), calls.cend(), std::move(call));
+            const auto [first, last] = _signal->listeners();
+            const auto it = std::find_if(first, last, [&call](const auto &elem)
+                                         { return elem.call == call; });
 
             slot other{*this};
-            other._offset = calls.cend() - it;
+            other._offset = last - it;
             return other;
         }
 
@@ -502,11 +826,11 @@ namespace escad
 
             if (value_or_instance)
             {
-                const auto &calls = _signal->calls;
-                const auto it = std::find_if(calls.cbegin(), calls.cend(), [value_or_instance](const auto &delegate)
-                                             { return delegate.data() == value_or_instance; });
+                const auto [first, last] = _signal->listeners();
+                const auto it = std::find_if(first, last, [value_or_instance](const auto &elem)
+                                             { return elem.call.data() == value_or_instance; });
 
-                other._offset = calls.cend() - it;
+                other._offset = last - it;
             }
 
             return other;
@@ -519,7 +843,7 @@ namespace escad
         [[nodiscard]] slot before()
         {
             slot other{*this};
-            other._offset = _signal->calls.size();
+            other._offset = static_cast<difference_type>(_signal->count);
             return other;
         }
 
@@ -533,7 +857,10 @@ namespace escad
          * checks to avoid multiple connections for the same function.<br/>
          * When used to connect a free function with payload, its signature must be
          * such that the instance is the first argument before the ones used to
-         * define the signal itself.
+         * define the signal itself.<br/>
+         * Looking for a previous connection takes linear time, see
+         * connect_unchecked. Releasing the returned connection takes constant
+         * time.
          *
          * @tparam Candidate Function or member to connect to the signal.
          * @tparam Type Type of class or type of payload, if any.
@@ -544,14 +871,33 @@ namespace escad
         connection connect(Type &&...value_or_instance)
         {
             disconnect<Candidate>(value_or_instance...);
+            return connect_unchecked<Candidate>(value_or_instance...);
+        }
 
+        /**
+         * @brief Connects a listener without checking whether it's already
+         * connected.
+         *
+         * Same as connect, except that users guarantee that the listener isn't
+         * connected yet. A listener connected twice is also invoked twice.<br/>
+         * Appending a listener takes constant time, connecting it before another
+         * one is linear in the number of listeners that follow.
+         *
+         * @tparam Candidate Function or member to connect to the signal.
+         * @tparam Type Type of class or type of payload, if any.
+         * @param value_or_instance A valid object that fits the purpose, if any.
+         * @return A properly initialized connection object.
+         */
+        template <auto Candidate, typename... Type>
+        connection connect_unchecked(Type &&...value_or_instance)
+        {
             delegate<Ret(Args...)> call{};
             call.template connect<Candidate>(value_or_instance...);
-            _signal->calls.insert(_signal->calls.end() - _offset, std::move(call));
+            const auto key = _signal->insert(_signal->count - static_cast<std::size_t>(_offset), std::move(call));
 
-            delegate<void(void *)> conn{};
-            conn.template connect<&release<Candidate, Type...>>(value_or_instance...);
-            return {std::move(conn), _signal};
+            delegate<void(void *, std::uint64_t)> conn{};
+            conn.template connect<&release>();
+            return {std::move(conn), _signal, key};
         }
 
         /**
@@ -564,10 +910,11 @@ namespace escad
         template <auto Candidate, typename... Type>
         void disconnect(Type &&...value_or_instance)
         {
-            auto &calls = _signal->calls;
             delegate<Ret(Args...)> call{};
             call.template connect<Candidate>(value_or_instance...);
-            calls.erase(std::remove(calls.begin(), calls.end(), std::move(call)), calls.end());
+            _signal->compact([&call](const auto &elem)
+                             { return elem == call; },
+                             false);
         }
 
         /**
@@ -593,17 +940,16 @@ namespace escad
         {
             if (value_or_instance)
             {
-                auto &calls = _signal->calls;
                 auto predicate = [value_or_instance](const auto &delegate)
                 { return delegate.data() == value_or_instance; };
-                calls.erase(std::remove_if(calls.begin(), calls.end(), std::move(predicate)), calls.end());
+                _signal->compact(std::move(predicate), false);
             }
         }
 
         /*! @brief Disconnects all the listeners from a signal. */
         void disconnect()
         {
-            _signal->calls.clear();
+            _signal->clear();
         }
 
     private:
@@ -620,8 +966,9 @@ namespace escad
      * @tparam Ret Return type of a function type.
      * @tparam Args Types of arguments of a function type.
      * @tparam Allocator Type of allocator used to manage memory and elements.
+     * @tparam InlineSize Number of listeners stored without allocating.
      */
-    template <typename Ret, typename... Args, typename Allocator>
-    slot(signal<Ret(Args...), Allocator> &) -> slot<signal<Ret(Args...), Allocator>>;
+    template <typename Ret, typename... Args, typename Allocator, std::size_t InlineSize>
+    slot(signal<Ret(Args...), Allocator, InlineSize> &) -> slot<signal<Ret(Args...), Allocator, InlineSize>>;
 
 } // namespace signal
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "../base/type_traits.h"
+#include "forwards.h"
+#include "inplace_delegate.h"
+
+namespace escad {
+
+/**
+ * @brief Event emitter for a closed set of events.
+ *
+ * To create an emitter type, derived classes must inherit from the base as:
+ *
+ * @code{.cpp}
+ * struct my_emitter: static_emitter<my_emitter, foo_event, bar_event> {
+ *     // ...
+ * }
+ * @endcode
+ *
+ * Unlike emitter, the accepted events are listed in advance. Every event has
+ * its own slot in a fixed array of handlers, so that publishing an event is an
+ * array access and a call, no lookup is involved. Publishing or listening for
+ * an event that isn't in the list results in a compile-time error.<br/>
+ * Whenever an event is published, an emitter also passes a reference to itself
+ * to its listeners.
+ *
+ * @tparam Derived Emitter type.
+ * @tparam Events Types of events accepted by the emitter.
+ */
+template<typename Derived, typename... Events>
+class static_emitter {
+    static_assert(sizeof...(Events) != 0u, "No events registered");
+    static_assert((std::is_same_v<Events, std::remove_cv_t<std::remove_reference_t<Events>>> && ...), "Invalid event type");
+
+    using events_type = mpl::type_list<Events...>;
+    using mapped_type = inplace_delegate<void(void *, Derived &)>;
+    using container_type = std::array<mapped_type, sizeof...(Events)>;
+
+    template<typename Type>
+    [[nodiscard]] static constexpr std::size_t index() noexcept {
+        using event_type = std::remove_cv_t<std::remove_reference_t<Type>>;
+        static_assert(mpl::type_list_contains_v<events_type, event_type>, "Unknown event type");
+        return mpl::type_list_index_v<event_type, events_type>;
+    }
+
+public:
+    /*! @brief Unsigned integer type. */
+    using size_type = std::size_t;
+
+    /*! @brief Default constructor. */
+    static_emitter() = default;
+
+    /*! @brief Default destructor. */
+    virtual ~static_emitter() noexcept {
+        static_assert(std::is_base_of_v<static_emitter<Derived, Events...>, Derived>, "Invalid emitter type");
+    }
+
+    /**
+     * @brief Move constructor.
+     * @param other The instance to move from.
+     */
+    static_emitter(static_emitter &&other) noexcept = default;
+
+    /**
+     * @brief Move assignment operator.
+     * @param other The instance to move from.
+     * @return This emitter.
+     */
+    static_emitter &operator=(static_emitter &&other) noexcept = default;
+
+    /**
+     * @brief Exchanges the contents with those of a given emitter.
+     * @param other Emitter to exchange the content with.
+     */
+    void swap(static_emitter &other) {
+        using std::swap;
+        swap(handlers, other.handlers);
+    }
+
+    /**
+     * @brief Returns the number of events accepted by the emitter.
+     * @return The number of events accepted by the emitter.
+     */
+    [[nodiscard]] static constexpr size_type size() noexcept {
+        return sizeof...(Events);
+    }
+
+    /**
+     * @brief Publishes a given event.
+     * @tparam Type Type of event to trigger.
+     * @param value An instance of the given type of event.
+     */
+    template<typename Type>
+    void publish(Type &&value) {
+        if(auto &handler = handlers[index<Type>()]; handler) {
+            handler(&value, static_cast<Derived &>(*this));
+        }
+    }
+
+    /**
+     * @brief Registers a listener with the event emitter.
+     *
+     * The listener is invoked with a reference to the event and a reference to
+     * the emitter. A listener registered earlier for the same event is
+     * replaced. Listeners that don't fit the inline storage of the handlers
+     * are moved to the heap.
+     *
+     * @tparam Type Type of event to which to connect the listener.
+     * @tparam Func Type of listener.
+     * @param func The listener to register.
+     */
+    template<typename Type, typename Func>
+    void on(Func func) {
+        if constexpr(mapped_type::template fits_inline<Func>) {
+            handlers[index<Type>()].emplace([func = std::move(func)](void *value, Derived &owner) mutable {
+                func(*static_cast<Type *>(value), owner);
+            });
+        } else {
+            handlers[index<Type>()].emplace([func = std::make_unique<Func>(std::move(func))](void *value, Derived &owner) {
+                (*func)(*static_cast<Type *>(value), owner);
+            });
+        }
+    }
+
+    /**
+     * @brief Disconnects a listener from the event emitter.
+     * @tparam Type Type of event of the listener.
+     */
+    template<typename Type>
+    void erase() noexcept {
+        handlers[index<Type>()].reset();
+    }
+
+    /*! @brief Disconnects all the listeners. */
+    void clear() noexcept {
+        for(auto &&handler: handlers) {
+            handler.reset();
+        }
+    }
+
+    /**
+     * @brief Checks if there are listeners registered for the specific event.
+     * @tparam Type Type of event to test.
+     * @return True if there are listeners registered, false otherwise.
+     */
+    template<typename Type>
+    [[nodiscard]] bool contains() const noexcept {
+        return static_cast<bool>(handlers[index<Type>()]);
+    }
+
+    /**
+     * @brief Checks if there are listeners registered with the event emitter.
+     * @return True if there are no listeners registered, false otherwise.
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        for(auto &&handler: handlers) {
+            if(handler) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    container_type handlers;
+};
+
+} // namespace escad
@@ -0,0 +1,252 @@
+/**
+ * @file static_signal.h
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief Signal with a fixed set of listeners known at compile time
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "../base/type_traits.h"
+#include "delegate.h"
+#include "forwards.h"
+
+namespace escad
+{
+    /**
+     * @brief Signal with a fixed set of listeners.
+     *
+     * Primary template isn't defined on purpose. All the specializations give a
+     * compile-time error unless the template parameter is a function type.
+     *
+     * @tparam Type A valid function type.
+     * @tparam Candidate Functions or members invoked when publishing.
+     */
+    template <typename Type, auto... Candidate>
+    class static_signal;
+
+    /**
+     * @brief Signal with a fixed set of listeners.
+     *
+     * The listeners are part of the type, as for delegate::connect a listener
+     * is a free function or an unbound member which accepts the arguments of
+     * the signal, or only the first ones. Publishing is a sequence of direct
+     * calls in the order of the listeners, which the compiler can inline. No
+     * delegate is involved and a static signal has no state:
+     *
+     * @code{.cpp}
+     * using metrics = escad::static_signal<void(const order &), &count_orders, &log_order>;
+     * metrics::publish(order);
+     * @endcode
+     *
+     * The interface is the one of signal without the connection management.
+     *
+     * @tparam Ret Return type of a function type.
+     * @tparam Args Types of arguments of a function type.
+     * @tparam Candidate Functions or members invoked when publishing.
+     */
+    template <typename Ret, typename... Args, auto... Candidate>
+    class static_signal<Ret(Args...), Candidate...>
+    {
+        template <auto Func, std::size_t... Index>
+        static Ret call(std::index_sequence<Index...>, Args... args)
+        {
+            [[maybe_unused]] const auto arguments = std::forward_as_tuple(std::forward<Args>(args)...);
+            return static_cast<Ret>(std::invoke(Func, std::forward<mpl::type_list_element_t<Index, mpl::type_list<Args...>>>(std::get<Index>(arguments))...));
+        }
+
+        // same rules as delegate::connect, trailing arguments can be dropped
+        template <auto Func>
+        static Ret call(connect_arg_t<Func>, Args... args)
+        {
+            if constexpr (std::is_invocable_r_v<Ret, decltype(Func), Args...>)
+            {
+                return static_cast<Ret>(std::invoke(Func, std::forward<Args>(args)...));
+            }
+            else if constexpr (std::is_member_pointer_v<decltype(Func)>)
+            {
+                return call<Func>(details::index_sequence_for<mpl::type_list_element_t<0, mpl::type_list<Args...>>>(details::function_pointer_t<decltype(Func)>{}), std::forward<Args>(args)...);
+            }
+            else
+            {
+                return call<Func>(details::index_sequence_for(details::function_pointer_t<decltype(Func)>{}), std::forward<Args>(args)...);
+            }
+        }
+
+        // true if the collector asks to stop
+        template <auto Func, typename Collector, typename... Params>
+        static bool invoke(connect_arg_t<Func> tag, Collector &func, Params &&...params)
+        {
+            if constexpr (std::is_void_v<Ret>)
+            {
+                call(tag, std::forward<Params>(params)...);
+
+                if constexpr (std::is_invocable_r_v<bool, Collector>)
+                {
+                    return func();
+                }
+                else
+                {
+                    func();
+                    return false;
+                }
+            }
+            else
+            {
+                if constexpr (std::is_invocable_r_v<bool, Collector, Ret>)
+                {
+                    return func(call(tag, std::forward<Params>(params)...));
+                }
+                else
+                {
+                    func(call(tag, std::forward<Params>(params)...));
+                    return false;
+                }
+            }
+        }
+
+    public:
+        /*! @brief Unsigned integer type. */
+        using size_type = std::size_t;
+
+        /**
+         * @brief Number of listeners of the signal.
+         * @return Number of listeners.
+         */
+        [[nodiscard]] static constexpr size_type size() noexcept
+        {
+            return sizeof...(Candidate);
+        }
+
+        /**
+         * @brief Returns false if the signal has listeners.
+         * @return True if the signal has no listeners, false otherwise.
+         */
+        [[nodiscard]] static constexpr bool empty() noexcept
+        {
+            return sizeof...(Candidate) == 0u;
+        }
+
+        /**
+         * @brief Triggers a signal.
+         *
+         * All the listeners are notified, in the order they are listed.
+         *
+         * @param args Arguments to use to invoke listeners.
+         */
+        static void publish(Args... args)
+        {
+            (call(connect_arg<Candidate>, args...), ...);
+        }
+
+        /**
+         * @brief Collects return values from the listeners.
+         *
+         * Same as signal::collect, a true value returned by the collector stops
+         * the iteration.
+         *
+         * @tparam Func Type of collector to use, if any.
+         * @param func A valid function object.
+         * @param args Arguments to use to invoke listeners.
+         */
+        template <typename Func>
+        static void collect(Func func, Args... args)
+        {
+            static_cast<void>((invoke(connect_arg<Candidate>, func, args...) || ...));
+        }
+
+        /**
+         * @brief Triggers a signal once for every element of a range.
+         *
+         * Same as signal::publish_batch, listeners are visited in the outer
+         * loop and elements in the inner one.
+         *
+         * @tparam It Type of forward iterator.
+         * @param first An iterator to the first element of the range.
+         * @param last An iterator past the last element of the range.
+         */
+        template <typename It>
+        static void publish_batch(It first, It last)
+        {
+            static_assert(sizeof...(Args) == 1u, "Batches require signals with a single argument");
+
+            ([first, last]()
+             {
+                 for (auto it = first; it != last; ++it)
+                 {
+                     call(connect_arg<Candidate>, *it);
+                 }
+             }(),
+             ...);
+        }
+
+        /**
+         * @brief Triggers a signal once for every element of a range.
+         * @tparam Range Type of range, e.g. a vector or a span.
+         * @param range A range of elements.
+         */
+        template <typename Range>
+        static void publish_batch(Range &&range)
+        {
+            publish_batch(std::begin(range), std::end(range));
+        }
+
+        /**
+         * @brief Collects return values from the listeners for a batch of
+         * elements.
+         *
+         * Same as signal::collect_batch, a true value returned by the collector
+         * stops the whole batch.
+         *
+         * @tparam Func Type of collector to use, if any.
+         * @tparam It Type of forward iterator.
+         * @param func A valid function object.
+         * @param first An iterator to the first element of the range.
+         * @param last An iterator past the last element of the range.
+         */
+        template <typename Func, typename It>
+        static void collect_batch(Func func, It first, It last)
+        {
+            static_assert(sizeof...(Args) == 1u, "Batches require signals with a single argument");
+
+            static_cast<void>(([&func, first, last]()
+                               {
+                                   for (auto it = first; it != last; ++it)
+                                   {
+                                       if (invoke(connect_arg<Candidate>, func, *it))
+                                       {
+                                           return true;
+                                       }
+                                   }
+
+                                   return false;
+                               }() ||
+                               ...));
+        }
+
+        /**
+         * @brief Collects return values from the listeners for a batch of
+         * elements.
+         * @tparam Func Type of collector to use, if any.
+         * @tparam Range Type of range, e.g. a vector or a span.
+         * @param func A valid function object.
+         * @param range A range of elements.
+         */
+        template <typename Func, typename Range>
+        static void collect_batch(Func func, Range &&range)
+        {
+            collect_batch(std::move(func), std::begin(range), std::end(range));
+        }
+    };
+
+} // namespace escad
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <base/allocation_hook.h>
+
+/**
+ * Assertions on the global allocations performed by an expression.
+ *
+ * Only usable in tests which define FSM_ALLOCATION_HOOK_IMPLEMENTATION before
+ * including base/allocation_hook.h (or this file) in exactly one translation
+ * unit.
+ */
+
+#define ESCAD_ALLOCATIONS_OF(...)                                              \
+  [&]() {                                                                      \
+    escad::allocation_scope escad_allocation_scope{};                          \
+    __VA_ARGS__;                                                               \
+    return escad_allocation_scope.allocations();                               \
+  }()
+
+#define REQUIRE_NO_ALLOCATIONS(...)                                            \
+  REQUIRE(ESCAD_ALLOCATIONS_OF(__VA_ARGS__) == 0u)
+
+#define CHECK_NO_ALLOCATIONS(...) CHECK(ESCAD_ALLOCATIONS_OF(__VA_ARGS__) == 0u)
+
+#define REQUIRE_ALLOCATIONS(N, ...)                                            \
+  REQUIRE(ESCAD_ALLOCATIONS_OF(__VA_ARGS__) == (N))
@@ -0,0 +1,299 @@
+#include <memory>
+#include <variant>
+
+#define FSM_ALLOCATION_HOOK_IMPLEMENTATION
+#include "allocations.h"
+
+#include <base/counting_allocator.h>
+#include <container/dense_map.h>
+#include <fsm/fsm.h>
+#include <fsm/ingress.h>
+#include <signal/dispatcher.h>
+#include <signal/emitter.h>
+#include <signal/inplace_delegate.h>
+#include <signal/ordered_dispatcher.h>
+#include <signal/signal.h>
+#include <signal/static_emitter.h>
+
+namespace {
+
+struct toggle {};
+
+struct Off;
+
+struct On {
+  auto transitionTo(const toggle &);
+};
+
+struct Off {
+  auto transitionTo(const toggle &);
+};
+
+auto On::transitionTo(const toggle &) { return Off{}; }
+
+auto Off::transitionTo(const toggle &) { return On{}; }
+
+struct Counter {
+  void receive(int value) { sum += value; }
+
+  void on_toggle(const toggle &) { ++toggles; }
+
+  int sum{0};
+  int toggles{0};
+};
+
+struct toggle_emitter : escad::static_emitter<toggle_emitter, toggle> {};
+
+struct counting_emitter
+    : escad::emitter<counting_emitter, escad::counting_allocator<void>> {
+  using escad::emitter<counting_emitter,
+                       escad::counting_allocator<void>>::emitter;
+};
+
+// global, so that the compiler cannot elide the allocations
+std::unique_ptr<int> holder{};
+
+} // namespace
+
+TEST_CASE("Allocation hook counts global allocations") {
+  auto &value = holder;
+  escad::allocation_scope scope{};
+
+  value = std::make_unique<int>(42);
+  value.reset();
+
+  REQUIRE(scope.allocations() == 1u);
+  REQUIRE(scope.deallocations() == 1u);
+  REQUIRE(scope.bytes() >= sizeof(int));
+
+  REQUIRE_ALLOCATIONS(1u, value = std::make_unique<int>(0));
+  REQUIRE_NO_ALLOCATIONS(*value = 1);
+  REQUIRE(*value == 1);
+}
+
+TEST_CASE("Signal publish does not allocate") {
+  escad::signal<void(int)> signal;
+  escad::slot slot{signal};
+  Counter counter;
+
+  slot.connect<&Counter::receive>(counter);
+
+  REQUIRE_NO_ALLOCATIONS(signal.publish(1));
+  REQUIRE(counter.sum == 1);
+}
+
+TEST_CASE("Signal connect allocates a single block") {
+  escad::signal<void(int)> signal;
+  escad::slot slot{signal};
+  Counter counter;
+
+  // listeners and connection keys share one allocation
+  REQUIRE_ALLOCATIONS(1u, slot.connect<&Counter::receive>(counter));
+  REQUIRE_NO_ALLOCATIONS(slot.disconnect(counter));
+  REQUIRE_NO_ALLOCATIONS(slot.connect<&Counter::receive>(counter).release());
+}
+
+TEST_CASE("Dispatcher trigger and update do not allocate") {
+  escad::dispatcher dispatcher;
+  Counter counter;
+
+  dispatcher.slot<toggle>().connect<&Counter::on_toggle>(counter);
+
+  // the first enqueue creates the handler and grows its queue
+  dispatcher.enqueue<toggle>();
+  dispatcher.update();
+
+  REQUIRE_NO_ALLOCATIONS(dispatcher.trigger(toggle{}));
+  REQUIRE_NO_ALLOCATIONS(dispatcher.enqueue<toggle>(); dispatcher.update());
+  REQUIRE(counter.toggles == 3);
+}
+
+TEST_CASE("Bounded dispatcher queue does not allocate") {
+  escad::dispatcher dispatcher;
+  Counter counter;
+
+  dispatcher.slot<toggle>().connect<&Counter::on_toggle>(counter);
+  dispatcher.bound<toggle>(8u, escad::overflow_policy::drop_oldest);
+
+  REQUIRE_NO_ALLOCATIONS(for (int pos{}; pos < 100; ++pos) {
+    dispatcher.enqueue<toggle>();
+    dispatcher.enqueue<toggle>();
+    dispatcher.update(1u);
+  });
+  REQUIRE(dispatcher.dropped() != 0u);
+}
+
+TEST_CASE("Bounded dispatcher queue takes events from listeners") {
+  escad::dispatcher dispatcher;
+  bool echo{};
+
+  dispatcher.bound<toggle>(4u, escad::overflow_policy::drop_oldest);
+  dispatcher.on<toggle>([&dispatcher, &echo](toggle &) {
+    if (echo) {
+      dispatcher.enqueue<toggle>();
+    }
+  });
+
+  const auto fill = [&dispatcher] {
+    for (int pos{}; pos < 4; ++pos) {
+      dispatcher.enqueue<toggle>();
+    }
+  };
+
+  REQUIRE_NO_ALLOCATIONS(fill(); dispatcher.update(2u));
+  // the delivered events are still ahead of the pending ones
+  fill();
+  echo = true;
+  REQUIRE_NO_ALLOCATIONS(dispatcher.update());
+  REQUIRE(dispatcher.size() == 4u);
+}
+
+TEST_CASE("FSM dispatch does not allocate") {
+  escad::fsm::fsm<std::variant<Off, On>> machine;
+
+  REQUIRE_NO_ALLOCATIONS(machine.dispatch(toggle{}));
+  REQUIRE(machine.is_state<On>());
+  REQUIRE_NO_ALLOCATIONS(machine.dispatch(toggle{}));
+  REQUIRE(machine.is_state<Off>());
+}
+
+TEST_CASE("Dense map lookup does not allocate") {
+  escad::dense_map<int, int> map;
+
+  for (int i = 0; i < 64; ++i) {
+    map.emplace(i, i);
+  }
+
+  REQUIRE_NO_ALLOCATIONS(REQUIRE(map.find(42) != map.end()));
+  REQUIRE_NO_ALLOCATIONS(REQUIRE(map.contains(7)));
+}
+
+TEST_CASE("Counting allocator") {
+  escad::allocation_stats stats{};
+
+  SECTION("signal") {
+    escad::signal<void(int), escad::counting_allocator<void>> signal{
+        escad::counting_allocator<void>{&stats}};
+    escad::slot slot{signal};
+    Counter counter;
+
+    slot.connect<&Counter::receive>(counter);
+
+    REQUIRE(stats.allocations != 0u);
+
+    const auto before = stats.allocations;
+    signal.publish(3);
+
+    REQUIRE(stats.allocations == before);
+    REQUIRE(counter.sum == 3);
+  }
+
+  SECTION("dispatcher") {
+    escad::basic_dispatcher<escad::counting_allocator<void>> dispatcher{
+        escad::counting_allocator<void>{&stats}};
+    Counter counter;
+
+    dispatcher.slot<toggle>().connect<&Counter::on_toggle>(counter);
+    dispatcher.enqueue<toggle>();
+    dispatcher.update();
+
+    REQUIRE(stats.allocations != 0u);
+
+    const auto before = stats.allocations;
+    dispatcher.trigger(toggle{});
+    dispatcher.enqueue<toggle>();
+    dispatcher.update();
+
+    REQUIRE(stats.allocations == before);
+    REQUIRE(counter.toggles == 3);
+  }
+
+  SECTION("emitter") {
+    counting_emitter emitter{escad::counting_allocator<void>{&stats}};
+
+    emitter.on<toggle>([](auto &, const auto &) {});
+
+    REQUIRE(stats.allocations != 0u);
+  }
+
+  SECTION("dense map") {
+    escad::dense_map<int, int, std::hash<int>, std::equal_to<int>,
+                     escad::counting_allocator<std::pair<const int, int>>>
+        map{escad::counting_allocator<std::pair<const int, int>>{&stats}};
+
+    map.emplace(1, 1);
+
+    REQUIRE(stats.allocations != 0u);
+
+    const auto before = stats.allocations;
+
+    REQUIRE(map.find(1) != map.end());
+    REQUIRE(stats.allocations == before);
+  }
+
+  REQUIRE(stats.live() == 0u);
+}
+
+TEST_CASE("Ingress dispatch_raw does not allocate") {
+  using protocol = escad::ingress<escad::ingress_event<1u, toggle>>;
+
+  escad::fsm::fsm<std::variant<Off, On>> machine;
+  const std::byte payload[1]{};
+
+  REQUIRE_NO_ALLOCATIONS(
+      REQUIRE(protocol::dispatch_raw(machine, 1u, payload, sizeof(toggle)) ==
+              escad::ingress_result::dispatched));
+  REQUIRE(machine.is_state<On>());
+}
+
+TEST_CASE("Small signal connects inline") {
+  escad::small_signal<void(int), 2u> signal;
+  escad::slot slot{signal};
+  Counter first;
+  Counter second;
+  Counter third;
+
+  REQUIRE_NO_ALLOCATIONS(slot.connect<&Counter::receive>(first));
+  REQUIRE_NO_ALLOCATIONS(slot.connect<&Counter::receive>(second));
+  REQUIRE_NO_ALLOCATIONS(signal.publish(1));
+  REQUIRE(ESCAD_ALLOCATIONS_OF(slot.connect<&Counter::receive>(third)) != 0u);
+  REQUIRE(first.sum + second.sum == 2);
+}
+
+TEST_CASE("Inplace delegate stores captures inline") {
+  escad::inplace_delegate<void(toggle &)> delegate;
+  Counter counter;
+  toggle event{};
+  int extra[3]{};
+
+  REQUIRE_NO_ALLOCATIONS(
+      delegate.emplace([&counter, extra](toggle &) { counter.toggles += 1 + extra[0]; }));
+  REQUIRE_NO_ALLOCATIONS(delegate(event));
+  REQUIRE(counter.toggles == 1);
+}
+
+TEST_CASE("Static emitter publish does not allocate") {
+  toggle_emitter emitter;
+  Counter counter;
+
+  REQUIRE_NO_ALLOCATIONS(emitter.on<toggle>(
+      [&counter](toggle &event, toggle_emitter &) { counter.on_toggle(event); }));
+  REQUIRE_NO_ALLOCATIONS(emitter.publish(toggle{}));
+  REQUIRE(counter.toggles == 1);
+}
+
+TEST_CASE("Ordered dispatcher enqueue and update do not allocate") {
+  escad::ordered_dispatcher dispatcher;
+  Counter counter;
+
+  dispatcher.slot<toggle>().connect<&Counter::on_toggle>(counter);
+  dispatcher.slot<int>().connect<&Counter::receive>(counter);
+  dispatcher.reserve_bytes(1024u);
+
+  REQUIRE_NO_ALLOCATIONS(for (int pos{}; pos < 100; ++pos) {
+    dispatcher.enqueue<toggle>();
+    dispatcher.enqueue(pos);
+    dispatcher.update();
+  });
+  REQUIRE(counter.toggles == 100);
+}
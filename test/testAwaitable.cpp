@@ -0,0 +1,278 @@
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#define FSM_ALLOCATION_HOOK_IMPLEMENTATION
+#include "allocations.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <base/hashed_string.h>
+#include <signal/awaitable.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+namespace {
+
+// eagerly started coroutine, destroyed along with the task
+struct task {
+    struct promise_type {
+        task get_return_object() {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> coro)
+        : handle{coro} {}
+
+    task(task &&other) noexcept
+        : handle{std::exchange(other.handle, {})} {}
+
+    ~task() {
+        if(handle) {
+            handle.destroy();
+        }
+    }
+
+    [[nodiscard]] bool done() const {
+        return handle.done();
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct an_event {
+    int value;
+};
+
+task collect(escad::awaitable_signal<void(an_event &)> &sig, std::vector<an_event *> &seen, int count) {
+    for(int pos{}; pos < count; ++pos) {
+        an_event &event = co_await sig.next();
+        seen.push_back(&event);
+    }
+}
+
+task handshake(escad::awaitable_signal<void(int, const std::string &)> &sig, std::vector<std::string> &log) {
+    auto [code, text] = co_await sig.next();
+    log.push_back(std::to_string(code) + text);
+
+    while(true) {
+        auto [other, reply] = co_await sig.next();
+
+        if(other == 0) {
+            break;
+        }
+
+        log.push_back(reply);
+    }
+}
+
+task receive(escad::awaitable_dispatcher &dispatcher, std::vector<int> &values, int count) {
+    for(int pos{}; pos < count; ++pos) {
+        an_event &event = co_await dispatcher.receive<an_event>();
+        values.push_back(event.value);
+    }
+}
+
+task receive_named(escad::awaitable_dispatcher &dispatcher, std::vector<int> &values) {
+    using namespace escad::literals;
+    int &value = co_await dispatcher.receive<int>("named"_hs);
+    values.push_back(value);
+}
+
+task wait_void(escad::awaitable_signal<void()> &sig, int &count) {
+    co_await sig.next();
+    ++count;
+    co_await sig.next();
+    ++count;
+}
+
+} // namespace
+
+TEST_CASE("Awaitable_SignalByReference", "[Awaitable]") {
+    escad::awaitable_signal<void(an_event &)> sig;
+    std::vector<an_event *> seen;
+    an_event first{1};
+    an_event second{2};
+
+    auto coro = collect(sig, seen, 2);
+
+    ASSERT_TRUE(sig.awaited());
+    ASSERT_EQ(sig.size(), 0u);
+
+    sig.publish(first);
+
+    ASSERT_EQ(seen.size(), 1u);
+    ASSERT_EQ(seen[0], &first);
+    ASSERT_TRUE(sig.awaited());
+
+    sig.publish(second);
+
+    ASSERT_EQ(seen.size(), 2u);
+    ASSERT_EQ(seen[1], &second);
+    ASSERT_FALSE(sig.awaited());
+    ASSERT_TRUE(coro.done());
+
+    sig.publish(first);
+    ASSERT_EQ(seen.size(), 2u);
+}
+
+TEST_CASE("Awaitable_SignalMultipleArguments", "[Awaitable]") {
+    escad::awaitable_signal<void(int, const std::string &)> sig;
+    escad::awaitable_signal<void()> empty;
+    std::vector<std::string> log;
+    int count{};
+
+    auto coro = handshake(sig, log);
+    auto other = wait_void(empty, count);
+
+    sig.publish(1, "hello");
+    sig.publish(2, "world");
+    sig.publish(0, "");
+
+    ASSERT_EQ(log, (std::vector<std::string>{"1hello", "world"}));
+    ASSERT_TRUE(coro.done());
+
+    empty.publish();
+    empty.publish();
+
+    ASSERT_EQ(count, 2);
+    ASSERT_TRUE(other.done());
+}
+
+TEST_CASE("Awaitable_ResumeOrderAndListeners", "[Awaitable]") {
+    escad::awaitable_signal<void(an_event &)> sig;
+    std::vector<an_event *> first;
+    std::vector<an_event *> second;
+    int calls{};
+
+    struct listener {
+        void receive(an_event &) {
+            ++*calls;
+        }
+
+        int *calls;
+    } instance{&calls};
+
+    escad::slot slot{sig};
+    slot.connect<&listener::receive>(instance);
+
+    auto lhs = collect(sig, first, 1);
+    auto rhs = collect(sig, second, 2);
+
+    an_event event{3};
+    sig.publish(event);
+
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(first.size(), 1u);
+    ASSERT_EQ(second.size(), 1u);
+    ASSERT_TRUE(lhs.done());
+    ASSERT_FALSE(rhs.done());
+}
+
+TEST_CASE("Awaitable_SignalBatch", "[Awaitable]") {
+    escad::awaitable_signal<void(an_event &)> sig;
+    std::vector<an_event *> seen;
+    std::vector<an_event> events{{1}, {2}, {3}};
+
+    auto coro = collect(sig, seen, 2);
+    sig.publish_batch(events);
+
+    ASSERT_EQ(seen, (std::vector<an_event *>{&events[0], &events[1]}));
+    ASSERT_TRUE(coro.done());
+}
+
+TEST_CASE("Awaitable_DestroyedWhileWaiting", "[Awaitable]") {
+    escad::awaitable_signal<void(an_event &)> sig;
+    std::vector<an_event *> seen;
+
+    {
+        auto coro = collect(sig, seen, 1);
+        ASSERT_TRUE(sig.awaited());
+    }
+
+    ASSERT_FALSE(sig.awaited());
+
+    an_event event{};
+    sig.publish(event);
+
+    ASSERT_TRUE(seen.empty());
+}
+
+TEST_CASE("Awaitable_Dispatcher", "[Awaitable]") {
+    using namespace escad::literals;
+
+    escad::awaitable_dispatcher dispatcher;
+    std::vector<int> values;
+    std::vector<int> named;
+
+    auto coro = receive(dispatcher, values, 3);
+    auto other = receive_named(dispatcher, named);
+
+    dispatcher.enqueue(an_event{1});
+    dispatcher.enqueue(an_event{2});
+
+    ASSERT_TRUE(values.empty());
+
+    dispatcher.update();
+
+    ASSERT_EQ(values, (std::vector<int>{1, 2}));
+
+    dispatcher.trigger(an_event{3});
+    dispatcher.trigger(an_event{4});
+
+    ASSERT_EQ(values, (std::vector<int>{1, 2, 3}));
+    ASSERT_TRUE(coro.done());
+
+    dispatcher.trigger(5);
+    ASSERT_TRUE(named.empty());
+
+    dispatcher.enqueue_hint("named"_hs, 6);
+    dispatcher.update();
+
+    ASSERT_EQ(named, (std::vector<int>{6}));
+    ASSERT_TRUE(other.done());
+}
+
+TEST_CASE("Awaitable_AwaitingDoesNotAllocate", "[Awaitable]") {
+    escad::awaitable_signal<void(an_event &)> sig;
+    escad::awaitable_dispatcher dispatcher;
+    std::vector<an_event *> seen;
+    std::vector<int> values;
+
+    seen.reserve(100u);
+    values.reserve(100u);
+    dispatcher.enqueue(an_event{0});
+    dispatcher.update();
+
+    auto coro = collect(sig, seen, 100);
+    auto other = receive(dispatcher, values, 100);
+    an_event event{};
+
+    REQUIRE_NO_ALLOCATIONS(for(int pos{}; pos < 100; ++pos) {
+        sig.publish(event);
+        dispatcher.trigger(an_event{pos});
+    });
+
+    ASSERT_TRUE(coro.done());
+    ASSERT_TRUE(other.done());
+}
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <base/hashed_string.h>
+#include <fsm/fsm.h>
+#include <signal/concurrent_dispatcher.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+struct an_event {
+    int producer;
+    int value;
+};
+
+struct another_event {};
+
+// makes the type non-aggregate
+struct message {
+    explicit message(std::string text)
+        : text{std::move(text)} {}
+
+    std::string text;
+};
+
+struct receiver {
+    void receive(an_event &event) {
+        ++cnt;
+        sum += event.value;
+    }
+
+    void on_message(message &msg) {
+        last = msg.text;
+    }
+
+    int cnt{0};
+    long long sum{0};
+    std::string last{};
+};
+
+struct toggle {};
+
+struct switched_on;
+
+struct switched_off {
+    switched_on transitionTo(const toggle &);
+};
+
+struct switched_on {
+    switched_off transitionTo(const toggle &) { return {}; }
+};
+
+switched_on switched_off::transitionTo(const toggle &) { return {}; }
+
+struct change_recorder {
+    void receive(const escad::state_change &change) {
+        changes.push_back(change);
+    }
+
+    std::vector<escad::state_change> changes{};
+};
+
+TEST_CASE("ConcurrentDispatcher_Functionalities", "[ConcurrentDispatcher]") {
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+
+    ASSERT_FALSE(dispatcher.frozen());
+    ASSERT_EQ(dispatcher.size(), 0u);
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.slot<message>().connect<&receiver::on_message>(receiver);
+
+    ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 1));
+    ASSERT_TRUE(dispatcher.enqueue(an_event{0, 2}));
+    ASSERT_TRUE(dispatcher.enqueue<message>("foo"));
+
+    ASSERT_EQ(dispatcher.size<an_event>(), 2u);
+    ASSERT_EQ(dispatcher.size(), 3u);
+
+    dispatcher.update<an_event>();
+
+    ASSERT_EQ(receiver.cnt, 2);
+    ASSERT_EQ(receiver.sum, 3);
+    ASSERT_EQ(dispatcher.size(), 1u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.last, "foo");
+    ASSERT_EQ(dispatcher.size(), 0u);
+
+    dispatcher.trigger(an_event{0, 4});
+
+    ASSERT_EQ(receiver.sum, 7);
+
+    dispatcher.enqueue<an_event>(0, 8);
+    dispatcher.clear<an_event>();
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.sum, 7);
+
+    dispatcher.disconnect(receiver);
+    dispatcher.trigger(an_event{0, 16});
+
+    ASSERT_EQ(receiver.sum, 7);
+}
+
+TEST_CASE("ConcurrentDispatcher_Freeze", "[ConcurrentDispatcher]") {
+    using namespace escad::literals;
+
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+
+    dispatcher.prepare<an_event>();
+    dispatcher.prepare<an_event>("named"_hs);
+    dispatcher.freeze();
+
+    ASSERT_TRUE(dispatcher.frozen());
+    ASSERT_FALSE(dispatcher.enqueue<another_event>());
+    ASSERT_FALSE(dispatcher.enqueue_hint<an_event>("unknown"_hs, 0, 1));
+    ASSERT_EQ(dispatcher.size<another_event>(), 0u);
+
+    dispatcher.slot<an_event>("named"_hs).connect<&receiver::receive>(receiver);
+
+    ASSERT_TRUE(dispatcher.enqueue_hint("named"_hs, an_event{0, 1}));
+    ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 2));
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.cnt, 1);
+    ASSERT_EQ(receiver.sum, 1);
+}
+
+TEST_CASE("ConcurrentDispatcher_PendingEventsAreDestroyed", "[ConcurrentDispatcher]") {
+    auto value = std::make_shared<int>(0);
+
+    {
+        escad::concurrent_dispatcher dispatcher;
+        dispatcher.enqueue(value);
+        dispatcher.enqueue(value);
+
+        ASSERT_EQ(value.use_count(), 3);
+    }
+
+    ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST_CASE("ConcurrentDispatcher_MultipleProducers", "[ConcurrentDispatcher]") {
+    constexpr int producers = 4;
+    constexpr int events = 10000;
+
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+    std::vector<int> last(producers, -1);
+    bool ordered = true;
+
+    struct checker {
+        void receive(an_event &event) {
+            *ordered = *ordered && (event.value == (*last)[event.producer] + 1);
+            (*last)[event.producer] = event.value;
+        }
+
+        std::vector<int> *last;
+        bool *ordered;
+    } check{&last, &ordered};
+
+    dispatcher.prepare<an_event>();
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.slot<an_event>().connect<&checker::receive>(check);
+    dispatcher.freeze();
+
+    std::atomic<int> running{producers};
+    std::vector<std::thread> threads;
+
+    for(int producer{}; producer < producers; ++producer) {
+        threads.emplace_back([&dispatcher, &running, producer]() {
+            for(int value{}; value < events; ++value) {
+                dispatcher.enqueue<an_event>(producer, value);
+            }
+
+            running.fetch_sub(1);
+        });
+    }
+
+    while(running.load() != 0) {
+        dispatcher.update();
+    }
+
+    for(auto &&thread: threads) {
+        thread.join();
+    }
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.cnt, producers * events);
+    ASSERT_EQ(dispatcher.size(), 0u);
+    ASSERT_TRUE(ordered);
+
+    for(auto &&elem: last) {
+        ASSERT_EQ(elem, events - 1);
+    }
+}
+
+TEST_CASE("ConcurrentDispatcher_BoundedReject", "[ConcurrentDispatcher]") {
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.bound<an_event>(3u);
+    dispatcher.bound<message>(1u);
+    dispatcher.freeze();
+
+    for(int value{}; value < 5; ++value) {
+        ASSERT_EQ(dispatcher.enqueue<an_event>(0, value), value < 3);
+    }
+
+    ASSERT_TRUE(dispatcher.enqueue<message>("foo"));
+    ASSERT_FALSE(dispatcher.enqueue<message>("bar"));
+
+    ASSERT_EQ(dispatcher.size<an_event>(), 3u);
+    ASSERT_EQ(dispatcher.dropped<an_event>(), 2u);
+    ASSERT_EQ(dispatcher.dropped(), 3u);
+    ASSERT_EQ(dispatcher.blocked<an_event>(), 0u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.cnt, 3);
+    ASSERT_EQ(receiver.sum, 3);
+    ASSERT_EQ(dispatcher.size(), 0u);
+
+    // the ring wraps around
+    for(int lap{}; lap < 4; ++lap) {
+        ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 1));
+        ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 1));
+        dispatcher.update();
+    }
+
+    ASSERT_EQ(receiver.cnt, 11);
+}
+
+TEST_CASE("ConcurrentDispatcher_BoundKeepsPendingEvents", "[ConcurrentDispatcher]") {
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.bound<an_event>(4u);
+
+    for(int value{}; value < 3; ++value) {
+        ASSERT_TRUE(dispatcher.enqueue<an_event>(0, value));
+    }
+
+    // a smaller ring, the pending events are kept anyway
+    dispatcher.bound<an_event>(2u);
+
+    ASSERT_EQ(dispatcher.size<an_event>(), 3u);
+    ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 3));
+    ASSERT_TRUE(dispatcher.enqueue<an_event>(0, 4));
+    ASSERT_FALSE(dispatcher.enqueue<an_event>(0, 5));
+
+    dispatcher.bound<an_event>(0u);
+
+    ASSERT_EQ(dispatcher.size<an_event>(), 5u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.cnt, 5);
+    ASSERT_EQ(receiver.sum, 10);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("ConcurrentDispatcher_PendingBoundedEventsAreDestroyed", "[ConcurrentDispatcher]") {
+    auto value = std::make_shared<int>(0);
+
+    {
+        escad::concurrent_dispatcher dispatcher;
+        dispatcher.bound<std::shared_ptr<int>>(2u);
+        dispatcher.freeze();
+
+        ASSERT_TRUE(dispatcher.enqueue(value));
+        ASSERT_TRUE(dispatcher.enqueue(value));
+        ASSERT_FALSE(dispatcher.enqueue(value));
+        ASSERT_EQ(value.use_count(), 3);
+    }
+
+    ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST_CASE("ConcurrentDispatcher_BoundedBlock", "[ConcurrentDispatcher]") {
+    constexpr int producers = 4;
+    constexpr int events = 10000;
+
+    escad::concurrent_dispatcher dispatcher;
+    receiver receiver;
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.bound<an_event>(16u, escad::overflow_policy::block);
+    dispatcher.freeze();
+
+    std::atomic<int> running{producers};
+    std::vector<std::thread> threads;
+
+    for(int producer{}; producer < producers; ++producer) {
+        threads.emplace_back([&dispatcher, &running, producer]() {
+            for(int value{}; value < events; ++value) {
+                dispatcher.enqueue<an_event>(producer, 1);
+            }
+
+            running.fetch_sub(1);
+        });
+    }
+
+    std::size_t largest{};
+
+    while(running.load() != 0) {
+        largest = std::max(largest, dispatcher.size<an_event>());
+        dispatcher.update();
+        // lets blocked producers in on a single core
+        std::this_thread::yield();
+    }
+
+    ASSERT_TRUE(largest <= 16u);
+
+    for(auto &&thread: threads) {
+        thread.join();
+    }
+
+    dispatcher.update();
+
+    ASSERT_EQ(receiver.cnt, producers * events);
+    ASSERT_EQ(receiver.sum, producers * events);
+    ASSERT_EQ(dispatcher.dropped(), 0u);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("ConcurrentDispatcher_StateChangesFromMachineThread", "[ConcurrentDispatcher]") {
+    constexpr std::size_t transitions = 1000u;
+
+    escad::concurrent_dispatcher dispatcher;
+    change_recorder recorder;
+
+    dispatcher.slot<escad::state_change>().connect<&change_recorder::receive>(recorder);
+    dispatcher.freeze();
+
+    std::atomic<bool> done{false};
+
+    // the machine dispatches on its own thread, observers run on this one
+    std::thread machine_thread{[&dispatcher, &done]() {
+        escad::fsm::fsm<std::variant<switched_off, switched_on>> machine;
+        machine.connect_changes(dispatcher, 3u);
+
+        for(std::size_t pos{}; pos < transitions; ++pos) {
+            machine.dispatch(toggle{});
+        }
+
+        done.store(true);
+    }};
+
+    while(!done.load()) {
+        dispatcher.update();
+        std::this_thread::yield();
+    }
+
+    machine_thread.join();
+    dispatcher.update();
+
+    ASSERT_EQ(recorder.changes.size(), transitions);
+
+    for(std::size_t pos{}; pos < transitions; ++pos) {
+        ASSERT_EQ(recorder.changes[pos].machine, 3u);
+        ASSERT_EQ(recorder.changes[pos].from, pos % 2u);
+        ASSERT_EQ(recorder.changes[pos].to, (pos + 1u) % 2u);
+    }
+}
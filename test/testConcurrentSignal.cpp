@@ -0,0 +1,191 @@
+/**
+ * @file testConcurrentSignal.cpp
+ * @author Martin Heubuch (martin.heubuch@escad.de)
+ * @brief
+ * @version 0.1
+ * @date 2024-04-02
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <signal/concurrent_signal.h>
+
+struct concurrent_listener {
+    void add(int v) {
+        value += v;
+    }
+
+    bool even(int v) {
+        return v % 2 == 0;
+    }
+
+    int value{};
+};
+
+struct self_disconnecting {
+    void once(int v) {
+        value += v;
+        escad::slot{*signal}.disconnect<&self_disconnecting::once>(*this);
+    }
+
+    void connect_other(int) {
+        escad::slot{*signal}.connect<&concurrent_listener::add>(other);
+    }
+
+    escad::concurrent_signal<void(int)> *signal{};
+    concurrent_listener other{};
+    int value{};
+};
+
+struct atomic_listener {
+    void add(int v) {
+        value.fetch_add(v, std::memory_order_relaxed);
+    }
+
+    std::atomic<int> value{};
+};
+
+TEST_CASE("ConcurrentSignal connect and publish") {
+    escad::concurrent_signal<void(int)> signal;
+    escad::slot slot{signal};
+    concurrent_listener listener;
+
+    REQUIRE(signal.empty());
+    REQUIRE(slot.empty());
+
+    signal.publish(1);
+
+    auto conn = slot.connect<&concurrent_listener::add>(listener);
+
+    REQUIRE(conn);
+    REQUIRE_FALSE(signal.empty());
+    REQUIRE(signal.size() == 1u);
+
+    signal.publish(2);
+
+    REQUIRE(listener.value == 2);
+
+    // no duplicates
+    slot.connect<&concurrent_listener::add>(listener);
+
+    REQUIRE(signal.size() == 1u);
+
+    conn.release();
+
+    REQUIRE(signal.empty());
+
+    signal.publish(3);
+
+    REQUIRE(listener.value == 2);
+
+    slot.connect<&concurrent_listener::add>(listener);
+    slot.disconnect(listener);
+
+    REQUIRE(signal.empty());
+}
+
+TEST_CASE("ConcurrentSignal collect") {
+    escad::concurrent_signal<bool(int)> signal;
+    escad::slot slot{signal};
+    concurrent_listener first;
+    concurrent_listener second;
+    int count{};
+
+    slot.connect<&concurrent_listener::even>(first);
+    slot.connect<&concurrent_listener::even>(second);
+
+    signal.collect([&count](bool value) { count += value; }, 2);
+
+    REQUIRE(count == 2);
+
+    signal.collect([&count](bool value) { ++count; return value; }, 4);
+
+    REQUIRE(count == 3);
+}
+
+TEST_CASE("ConcurrentSignal modify from listener") {
+    escad::concurrent_signal<void(int)> signal;
+    self_disconnecting listener;
+    listener.signal = &signal;
+
+    escad::slot slot{signal};
+    slot.connect<&self_disconnecting::once>(listener);
+    slot.connect<&self_disconnecting::connect_other>(listener);
+
+    signal.publish(5);
+
+    REQUIRE(listener.value == 5);
+    // the new listener is part of the next snapshot only
+    REQUIRE(listener.other.value == 0);
+    REQUIRE(signal.size() == 2u);
+
+    signal.publish(7);
+
+    REQUIRE(listener.value == 5);
+    REQUIRE(listener.other.value == 7);
+}
+
+TEST_CASE("ConcurrentSignal reclaims retired snapshots") {
+    escad::concurrent_signal<void(int)> signal;
+    escad::slot slot{signal};
+    concurrent_listener listener;
+
+    for (int i = 0; i < 16; ++i) {
+        slot.connect<&concurrent_listener::add>(listener);
+        slot.disconnect(listener);
+    }
+
+    // without publishers every grace period completes immediately
+    REQUIRE(signal.retired_size() == 0u);
+}
+
+TEST_CASE("ConcurrentSignal publish while connecting") {
+    constexpr int publishers = 4;
+    constexpr int rounds = 2000;
+
+    escad::concurrent_signal<void(int)> signal;
+    atomic_listener stable;
+    std::vector<atomic_listener> churn(8u);
+    std::atomic<bool> done{false};
+
+    escad::slot{signal}.connect<&atomic_listener::add>(stable);
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < publishers; ++i) {
+        threads.emplace_back([&]() {
+            for (int round = 0; round < rounds; ++round) {
+                signal.publish(1);
+            }
+        });
+    }
+
+    threads.emplace_back([&]() {
+        escad::slot slot{signal};
+
+        while (!done.load()) {
+            for (auto &listener : churn) {
+                slot.connect<&atomic_listener::add>(listener);
+            }
+
+            for (auto &listener : churn) {
+                slot.disconnect(listener);
+            }
+        }
+    });
+
+    for (int i = 0; i < publishers; ++i) {
+        threads[i].join();
+    }
+
+    done.store(true);
+    threads.back().join();
+
+    REQUIRE(stable.value.load() == publishers * rounds);
+    REQUIRE(signal.size() == 1u);
+}
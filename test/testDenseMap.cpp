@@ -1,13 +1,16 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -29,6 +32,7 @@
 #define ASSERT_LE(EXPR1, EXPR2) REQUIRE(EXPR1 <= EXPR2)
 #define ASSERT_GT(EXPR1, EXPR2) REQUIRE(EXPR1 > EXPR2)
 #define ASSERT_GE(EXPR1, EXPR2) REQUIRE(EXPR1 >= EXPR2)
+#define ASSERT_THROW(EXPR, TYPE) REQUIRE_THROWS_AS(EXPR, TYPE)
 
 struct transparent_equal_to {
     using is_transparent = void;
@@ -1167,6 +1171,382 @@ TEST_CASE("DenseMap_Reserve", ) {
     ASSERT_EQ(map.bucket_count(), 2 * minimum_bucket_count);
     ASSERT_EQ(map.bucket_count(), escad::next_power_of_two(std::ceil(minimum_bucket_count / map.max_load_factor())));
 }
+
+template<typename Key, typename Type, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using control_map = escad::dense_map<Key, Type, Hash, KeyEqual, std::allocator<std::pair<const Key, Type>>, escad::control_bytes>;
+
+struct constant_hash {
+    std::size_t operator()(const std::size_t) const noexcept {
+        return 42u;
+    }
+};
+
+TEST_CASE("DenseMap_ControlBytes", ) {
+    static constexpr std::size_t group_width = 16u;
+    control_map<std::size_t, std::size_t, escad::identity> map;
+
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.bucket_count(), group_width);
+
+    for(std::size_t next{}; next < group_width; ++next) {
+        ASSERT_TRUE(map.emplace(next, next * 2u).second);
+    }
+
+    ASSERT_FALSE(map.emplace(3u, 0u).second);
+    ASSERT_EQ(map.size(), group_width);
+    ASSERT_EQ(map.bucket_count(), 2u * group_width);
+    ASSERT_LE(map.load_factor(), map.max_load_factor());
+
+    for(std::size_t next{}; next < group_width; ++next) {
+        ASSERT_EQ(map.at(next), next * 2u);
+        ASSERT_EQ(map.bucket_size(map.bucket(next)), 1u);
+        ASSERT_EQ(map.begin(map.bucket(next))->first, next);
+    }
+
+    ASSERT_FALSE(map.contains(group_width));
+    ASSERT_EQ(map.bucket_size(map.bucket(group_width)), 0u);
+
+    // the elements stay densely packed in insertion order
+    ASSERT_EQ(map.begin()->first, 0u);
+    ASSERT_EQ((--map.end())->first, group_width - 1u);
+
+    ASSERT_EQ(map.erase(0u), 1u);
+    ASSERT_EQ(map.erase(0u), 0u);
+    ASSERT_EQ(map.begin()->first, group_width - 1u);
+    ASSERT_EQ(map.find(group_width - 1u), map.begin());
+
+    map.insert_or_assign(group_width - 1u, 0u);
+    map[group_width] = 1u;
+
+    ASSERT_EQ(map.at(group_width - 1u), 0u);
+    ASSERT_EQ(map.at(group_width), 1u);
+
+    map.erase(map.begin(), map.end());
+
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.find(1u), map.end());
+
+    map.clear();
+
+    ASSERT_EQ(map.bucket_count(), group_width);
+}
+
+TEST_CASE("DenseMap_ControlBytesTransparent", ) {
+    control_map<std::size_t, std::size_t, escad::identity, transparent_equal_to> map;
+    map.emplace(std::piecewise_construct, std::make_tuple(3u), std::make_tuple(42u));
+
+    ASSERT_TRUE(map.contains(3));
+    ASSERT_FALSE(map.contains(4));
+    ASSERT_EQ(map.find(3)->second, 42u);
+    ASSERT_EQ(map.count(3), 1u);
+}
+
+TEST_CASE("DenseMap_ControlBytesCollisions", ) {
+    control_map<std::size_t, std::size_t, constant_hash> map;
+
+    for(std::size_t next{}; next < 100u; ++next) {
+        map.emplace(next, next);
+    }
+
+    for(std::size_t next{}; next < 100u; next += 2u) {
+        ASSERT_EQ(map.erase(next), 1u);
+    }
+
+    const auto buckets = map.bucket_count();
+
+    for(std::size_t next{}; next < 100u; ++next) {
+        ASSERT_EQ(map.contains(next), ((next % 2u) != 0u));
+    }
+
+    // deleted slots are reused, then dropped by a rehash
+    for(std::size_t next{}; next < 100u; next += 2u) {
+        map.emplace(next, next);
+    }
+
+    map.rehash(0u);
+
+    ASSERT_EQ(map.bucket_count(), buckets);
+    ASSERT_EQ(map.size(), 100u);
+
+    for(std::size_t next{}; next < 100u; ++next) {
+        ASSERT_EQ(map.at(next), next);
+    }
+}
+
+TEST_CASE("DenseMap_ControlBytesMatchesChained", ) {
+    control_map<std::size_t, std::size_t> map;
+    escad::dense_map<std::size_t, std::size_t> other;
+    std::size_t seed{1u};
+
+    for(std::size_t step{}; step < 20000u; ++step) {
+        // simple LCG, keeps the sequence stable across platforms
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const auto key = (seed >> 33u) % 500u;
+
+        if(step % 3u == 0u) {
+            ASSERT_EQ(map.erase(key), other.erase(key));
+        } else {
+            ASSERT_EQ(map.insert_or_assign(key, step).second, other.insert_or_assign(key, step).second);
+        }
+
+        ASSERT_EQ(map.size(), other.size());
+    }
+
+    for(auto &&elem: other) {
+        ASSERT_EQ(map.at(elem.first), elem.second);
+    }
+
+    control_map<std::size_t, std::size_t> copy{map};
+    control_map<std::size_t, std::size_t> moved{std::move(copy)};
+    moved.swap(map);
+
+    ASSERT_EQ(moved.size(), map.size());
+    ASSERT_EQ(moved.begin()->first, map.begin()->first);
+}
+TEST_CASE("DenseMap_FindHashed", ) {
+    escad::dense_map<std::size_t, std::size_t, escad::identity> map;
+    control_map<std::size_t, std::size_t, escad::identity> other;
+
+    ASSERT_TRUE(map.insert_hashed({3u, 42u}, 3u).second);
+    ASSERT_FALSE(map.insert_hashed({3u, 0u}, 3u).second);
+    ASSERT_TRUE(other.insert_hashed(std::make_pair(3u, 42u), 3u).second);
+    ASSERT_FALSE(other.insert_hashed(std::make_pair(3u, 0u), 3u).second);
+
+    const std::pair<const std::size_t, std::size_t> value{5u, 7u};
+    map.insert_hashed(value, 5u);
+    other.insert_hashed(value, 5u);
+
+    ASSERT_EQ(map.find_hashed(3u, 3u)->second, 42u);
+    ASSERT_EQ(std::as_const(map).find_hashed(5u, 5u)->second, 7u);
+    ASSERT_EQ(map.find_hashed(4u, 4u), map.end());
+    ASSERT_EQ(other.find_hashed(3u, 3u)->second, 42u);
+    ASSERT_EQ(std::as_const(other).find_hashed(5u, 5u)->second, 7u);
+    ASSERT_EQ(other.find_hashed(4u, 4u), other.end());
+}
+
+template<typename Map>
+void find_batch_matches_find() {
+    Map map;
+    std::vector<std::size_t> keys{};
+
+    // more keys than a chunk, some of them missing
+    for(std::size_t next{}; next < 100u; ++next) {
+        if(next % 3u != 0u) {
+            map.emplace(next, next * 2u);
+        }
+
+        keys.push_back(next);
+    }
+
+    std::vector<typename Map::iterator> found{};
+    map.find_batch(keys, std::back_inserter(found));
+
+    ASSERT_EQ(found.size(), keys.size());
+
+    for(std::size_t pos{}; pos < keys.size(); ++pos) {
+        ASSERT_TRUE(found[pos] == map.find(keys[pos]));
+    }
+
+    typename Map::const_iterator cfound[4u]{};
+    const auto last = std::as_const(map).find_batch(keys.begin(), keys.begin() + 4u, cfound);
+
+    ASSERT_TRUE(last == std::end(cfound));
+    ASSERT_TRUE(cfound[0u] == map.cend());
+    ASSERT_EQ(cfound[1u]->second, 2u);
+
+    ASSERT_TRUE(map.find_batch(keys.begin(), keys.begin(), cfound) == cfound);
+}
+
+TEST_CASE("DenseMap_FindBatch", ) {
+    find_batch_matches_find<escad::dense_map<std::size_t, std::size_t>>();
+    find_batch_matches_find<control_map<std::size_t, std::size_t>>();
+    find_batch_matches_find<control_map<std::size_t, std::size_t, constant_hash>>();
+}
+
+template<typename Index, typename Layout = escad::chained_buckets>
+using compact_map = escad::dense_map<std::size_t, std::size_t, std::hash<std::size_t>, std::equal_to<std::size_t>, std::allocator<std::pair<const std::size_t, std::size_t>>, Layout, Index>;
+
+template<typename Map>
+void compact_map_matches_default() {
+    Map map;
+    escad::dense_map<std::size_t, std::size_t> other;
+    std::size_t seed{7u};
+
+    for(std::size_t step{}; step < 20000u; ++step) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const auto key = (seed >> 33u) % 3000u;
+
+        if(step % 3u == 0u) {
+            ASSERT_EQ(map.erase(key), other.erase(key));
+        } else {
+            ASSERT_EQ(map.insert_or_assign(key, step).second, other.insert_or_assign(key, step).second);
+        }
+    }
+
+    ASSERT_EQ(map.size(), other.size());
+
+    for(auto &&elem: other) {
+        ASSERT_EQ(map.at(elem.first), elem.second);
+
+        const auto bucket = map.bucket(elem.first);
+        std::size_t found{};
+
+        for(auto it = map.begin(bucket), last = map.end(bucket); it != last; ++it) {
+            found += (it->first == elem.first);
+        }
+
+        ASSERT_EQ(found, 1u);
+    }
+
+    map.rehash(0u);
+
+    ASSERT_EQ(map.size(), other.size());
+    ASSERT_FALSE(map.contains(3000u));
+}
+
+TEST_CASE("DenseMap_CompactIndex", ) {
+    using node_type = escad::details::dense_map_node<int, int>;
+    using compact_node_type = escad::details::dense_map_node<int, int, std::uint32_t>;
+
+    ASSERT_TRUE(sizeof(compact_node_type) < sizeof(node_type));
+    ASSERT_EQ(compact_map<std::uint16_t>{}.max_size(), 65535u);
+    ASSERT_EQ((compact_map<std::uint32_t, escad::control_bytes>{}.max_size()), 4294967295u);
+
+    compact_map_matches_default<compact_map<std::uint32_t>>();
+    compact_map_matches_default<compact_map<std::uint16_t>>();
+    compact_map_matches_default<compact_map<std::uint16_t, escad::control_bytes>>();
+}
+
+template<typename Map>
+void compact_map_full() {
+    Map map;
+
+    ASSERT_THROW(map.reserve(256u), std::length_error);
+
+    for(std::size_t next{}; next < map.max_size(); ++next) {
+        ASSERT_TRUE(map.emplace(next, next).second);
+    }
+
+    ASSERT_EQ(map.size(), 255u);
+
+    for(std::size_t next{}; next < map.max_size(); ++next) {
+        ASSERT_EQ(map.at(next), next);
+    }
+
+    // existing keys are still found, new ones don't fit
+    ASSERT_FALSE(map.emplace(0u, 1u).second);
+    ASSERT_FALSE(map.insert_or_assign(1u, 2u).second);
+    ASSERT_EQ(map.at(1u), 2u);
+
+    ASSERT_THROW(map.emplace(255u, 0u), std::length_error);
+    ASSERT_THROW(map.insert_or_assign(255u, 0u), std::length_error);
+    ASSERT_THROW(map.emplace(std::piecewise_construct, std::make_tuple(255u), std::make_tuple(0u)), std::length_error);
+    ASSERT_THROW(map[255u], std::length_error);
+
+    ASSERT_EQ(map.size(), 255u);
+    ASSERT_FALSE(map.contains(255u));
+    ASSERT_EQ(map.erase(0u), 1u);
+    ASSERT_EQ(map.at(254u), 254u);
+    ASSERT_TRUE(map.emplace(255u, 255u).second);
+    ASSERT_EQ(map.at(255u), 255u);
+}
+
+TEST_CASE("DenseMap_CompactIndexFull", ) {
+    compact_map_full<compact_map<std::uint8_t>>();
+    compact_map_full<compact_map<std::uint8_t, escad::control_bytes>>();
+    compact_map_full<compact_map<std::uint8_t, escad::incremental_buckets>>();
+}
+
+template<typename Key, typename Type>
+using incremental_map = escad::dense_map<Key, Type, std::hash<Key>, std::equal_to<Key>, std::allocator<std::pair<const Key, Type>>, escad::incremental_buckets>;
+
+template<typename Map>
+std::size_t elements_in_buckets(const Map &map) {
+    std::size_t count{};
+
+    for(std::size_t bucket{}; bucket < map.bucket_count(); ++bucket) {
+        count += map.bucket_size(bucket);
+    }
+
+    return count;
+}
+
+TEST_CASE("DenseMap_IncrementalRehash", ) {
+    incremental_map<std::size_t, std::size_t> map;
+    const auto buckets = map.bucket_count();
+    std::size_t next{};
+
+    for(; map.bucket_count() == buckets; ++next) {
+        map.emplace(next, next);
+    }
+
+    // the previous buckets are only partly moved
+    ASSERT_EQ(map.bucket_count(), 2u * buckets);
+    ASSERT_LT(elements_in_buckets(map), map.size());
+
+    for(std::size_t pos{}; pos < next; ++pos) {
+        ASSERT_EQ(map.at(pos), pos);
+        ASSERT_EQ(std::as_const(map).find(pos)->second, pos);
+    }
+
+    const incremental_map<std::size_t, std::size_t> copy{map};
+
+    ASSERT_EQ(map.erase(0u), 1u);
+    ASSERT_FALSE(map.contains(0u));
+    ASSERT_TRUE(copy.contains(0u));
+
+    map.rehash(map.bucket_count());
+
+    ASSERT_EQ(map.bucket_count(), 2u * buckets);
+    ASSERT_EQ(elements_in_buckets(map), map.size());
+
+    map.emplace(0u, 0u);
+    map.clear();
+
+    ASSERT_TRUE(map.empty());
+    ASSERT_FALSE(map.contains(1u));
+    ASSERT_EQ(elements_in_buckets(map), 0u);
+}
+
+TEST_CASE("DenseMap_IncrementalRehashMatchesChained", ) {
+    incremental_map<std::size_t, std::size_t> map;
+    escad::dense_map<std::size_t, std::size_t> other;
+    std::size_t seed{11u};
+
+    for(std::size_t step{}; step < 50000u; ++step) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const auto key = (seed >> 33u) % 20000u;
+
+        if(step % 4u == 0u) {
+            ASSERT_EQ(map.erase(key), other.erase(key));
+        } else if(step % 4u == 1u) {
+            ASSERT_EQ(map.emplace(key, step).second, other.emplace(key, step).second);
+        } else {
+            ASSERT_EQ(map.insert_or_assign(key, step).second, other.insert_or_assign(key, step).second);
+        }
+
+        ASSERT_EQ(map.size(), other.size());
+    }
+
+    std::vector<std::size_t> keys{};
+
+    for(auto &&elem: other) {
+        ASSERT_EQ(map.at(elem.first), elem.second);
+        keys.push_back(elem.first);
+    }
+
+    std::vector<incremental_map<std::size_t, std::size_t>::const_iterator> found{};
+    std::as_const(map).find_batch(keys, std::back_inserter(found));
+
+    for(std::size_t pos{}; pos < keys.size(); ++pos) {
+        ASSERT_EQ(found[pos]->first, keys[pos]);
+    }
+
+    map.rehash(0u);
+
+    ASSERT_EQ(elements_in_buckets(map), map.size());
+}
+
 #if false
 TEST_CASE("DenseMap_ThrowingAllocator", ) {
     using allocator = test::throwing_allocator<std::pair<const std::size_t, std::size_t>>;
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -25,6 +30,18 @@ struct one_more_event {
     one_more_event(int) {}
 };
 
+struct position {
+    int entity;
+    int x;
+};
+
+template<>
+struct escad::coalesce_traits<position> {
+    static int key(const position &event) {
+        return event.entity;
+    }
+};
+
 struct receiver {
     static void forward(escad::dispatcher &dispatcher, an_event &event) {
         dispatcher.enqueue(event);
@@ -199,6 +216,441 @@ TEST_CASE("Dispatcher_NamedQueue", "[Dispatcher]") {
     ASSERT_EQ(receiver.cnt, 3);
 }
 
+TEST_CASE("Dispatcher_IndexedQueue", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    receiver receiver;
+
+    // the default id spelled out reaches the same queue
+    dispatcher.slot<an_event>(escad::type_hash<an_event>::value()).connect<&receiver::receive>(receiver);
+    dispatcher.trigger(an_event{});
+
+    ASSERT_EQ(receiver.cnt, 1);
+
+    escad::dispatcher other{std::move(dispatcher)};
+    other.trigger(an_event{});
+    other.enqueue<an_event>();
+    other.update();
+
+    ASSERT_EQ(receiver.cnt, 3);
+
+    dispatcher = std::move(other);
+    other.swap(dispatcher);
+    other.trigger(an_event{});
+
+    ASSERT_EQ(receiver.cnt, 4);
+
+    receiver.reset();
+    other.trigger(escad::type_hash<an_event>::value(), an_event{});
+
+    ASSERT_EQ(receiver.cnt, 1);
+}
+
+TEST_CASE("Dispatcher_OwnedListeners", "[Dispatcher]") {
+    using namespace escad::literals;
+
+    escad::dispatcher dispatcher;
+    receiver receiver;
+    int count{};
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.on<an_event>([&count, &receiver](an_event &) {
+        // owned listeners run after the ones connected through the sink
+        count += receiver.cnt;
+    });
+    dispatcher.on<an_event>("named"_hs, [&count](an_event &) { count += 10; });
+
+    dispatcher.trigger<an_event>();
+
+    ASSERT_EQ(count, 1);
+
+    dispatcher.enqueue<an_event>();
+    dispatcher.enqueue_hint<an_event>("named"_hs);
+    dispatcher.update();
+
+    ASSERT_EQ(count, 13);
+
+    dispatcher.off<an_event>();
+    dispatcher.trigger<an_event>();
+
+    ASSERT_EQ(receiver.cnt, 3);
+    ASSERT_EQ(count, 13);
+
+    dispatcher.off<an_event>("named"_hs);
+    dispatcher.trigger("named"_hs, an_event{});
+
+    ASSERT_EQ(count, 13);
+}
+
+TEST_CASE("Dispatcher_BudgetedUpdate", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    receiver receiver;
+    int others{};
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+    dispatcher.on<another_event>([&others](another_event &) { ++others; });
+
+    for(int pos{}; pos < 10; ++pos) {
+        dispatcher.enqueue<an_event>();
+        dispatcher.enqueue<another_event>();
+    }
+
+    ASSERT_EQ(dispatcher.update(4u), 16u);
+    ASSERT_EQ(receiver.cnt, 2);
+    ASSERT_EQ(others, 2);
+
+    // the budget is shared, the next call resumes with the other queue
+    ASSERT_EQ(dispatcher.update(3u), 13u);
+    ASSERT_EQ(receiver.cnt + others, 7);
+    ASSERT_EQ(dispatcher.update(1u), 12u);
+    ASSERT_EQ(receiver.cnt, 4);
+    ASSERT_EQ(others, 4);
+
+    ASSERT_EQ(dispatcher.update(0u), 12u);
+    ASSERT_EQ(dispatcher.update(100u), 0u);
+    ASSERT_EQ(receiver.cnt, 10);
+    ASSERT_EQ(others, 10);
+}
+
+TEST_CASE("Dispatcher_DeadlineUpdate", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    receiver receiver;
+
+    dispatcher.slot<an_event>().connect<&receiver::receive>(receiver);
+
+    for(int pos{}; pos < 100; ++pos) {
+        dispatcher.enqueue<an_event>();
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(dispatcher.update(now - std::chrono::seconds{1}), 100u);
+    ASSERT_EQ(receiver.cnt, 0);
+    ASSERT_EQ(dispatcher.update(now + std::chrono::hours{1}), 0u);
+    ASSERT_EQ(receiver.cnt, 100);
+}
+
+TEST_CASE("Dispatcher_PartialUpdateKeepsOrder", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> values;
+
+    dispatcher.on<int>([&values](int &value) { values.push_back(value); });
+
+    for(int pos{}; pos < 5; ++pos) {
+        dispatcher.enqueue(pos);
+    }
+
+    ASSERT_EQ(dispatcher.update(2u), 3u);
+
+    dispatcher.enqueue(5);
+    dispatcher.enqueue(6);
+
+    ASSERT_EQ(dispatcher.update(1u), 4u);
+
+    dispatcher.update<int>();
+
+    ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("Dispatcher_ClearWhileDelivering", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    int count{};
+
+    dispatcher.on<an_event>([&dispatcher, &count](an_event &) {
+        ++count;
+        dispatcher.clear<an_event>();
+    });
+
+    dispatcher.enqueue<an_event>();
+    dispatcher.enqueue<an_event>();
+    dispatcher.update();
+
+    ASSERT_EQ(count, 1);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("Dispatcher_ClearWhileBudgetedUpdate", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> values;
+
+    dispatcher.on<int>([&dispatcher, &values](int &value) {
+        values.push_back(value);
+
+        if(value == 5) {
+            dispatcher.clear<int>();
+            dispatcher.enqueue(100);
+            dispatcher.enqueue(101);
+        }
+    });
+
+    for(int pos{}; pos < 10; ++pos) {
+        dispatcher.enqueue(pos);
+    }
+
+    ASSERT_EQ(dispatcher.update(3u), 7u);
+
+    // the queue is cleared half way through, the budget still holds
+    ASSERT_EQ(dispatcher.update(4u), 1u);
+    ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5, 100}));
+
+    ASSERT_EQ(dispatcher.update(4u), 0u);
+    ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5, 100, 101}));
+}
+
+TEST_CASE("Dispatcher_Coalescing", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<std::pair<int, int>> delivered;
+
+    dispatcher.on<position>([&delivered](position &event) {
+        delivered.emplace_back(event.entity, event.x);
+    });
+
+    dispatcher.enqueue<position>(1, 10);
+    dispatcher.enqueue<position>(2, 20);
+    dispatcher.enqueue(position{1, 11});
+    dispatcher.enqueue<position>(3, 30);
+    dispatcher.enqueue(position{1, 12});
+    dispatcher.enqueue(position{2, 21});
+
+    ASSERT_EQ(dispatcher.size<position>(), 3u);
+
+    ASSERT_EQ(dispatcher.update(2u), 1u);
+
+    // delivered events no longer absorb newer ones
+    dispatcher.enqueue(position{1, 13});
+    dispatcher.enqueue(position{3, 31});
+
+    ASSERT_EQ(dispatcher.size<position>(), 2u);
+
+    dispatcher.update();
+
+    const std::vector<std::pair<int, int>> expected{{1, 12}, {2, 21}, {3, 31}, {1, 13}};
+
+    ASSERT_EQ(delivered, expected);
+
+    dispatcher.enqueue(position{1, 14});
+    dispatcher.clear<position>();
+    dispatcher.enqueue(position{1, 15});
+    dispatcher.update();
+
+    ASSERT_EQ(delivered.back(), (std::pair<int, int>{1, 15}));
+    ASSERT_EQ(delivered.size(), 5u);
+}
+
+TEST_CASE("Dispatcher_CoalescingCompaction", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> delivered;
+
+    dispatcher.on<position>([&delivered](position &event) {
+        delivered.push_back(event.x);
+    });
+
+    for(int entity{}; entity < 8; ++entity) {
+        dispatcher.enqueue(position{entity, entity});
+    }
+
+    // drops the delivered events and shifts the pending ones to the front
+    ASSERT_EQ(dispatcher.update(6u), 2u);
+
+    dispatcher.enqueue(position{7, 70});
+    dispatcher.enqueue(position{6, 60});
+    dispatcher.enqueue(position{0, 100});
+    dispatcher.update();
+
+    ASSERT_EQ(delivered, (std::vector<int>{0, 1, 2, 3, 4, 5, 60, 70, 100}));
+}
+
+TEST_CASE("Dispatcher_BoundedRejectNewest", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> delivered;
+    std::vector<int> rejected;
+
+    dispatcher.on<int>([&delivered](int &value) { delivered.push_back(value); });
+    dispatcher.bound<int>(3u, escad::overflow_policy::reject_newest, [&rejected](int &value) { rejected.push_back(value); });
+
+    for(int pos{}; pos < 5; ++pos) {
+        ASSERT_EQ(dispatcher.enqueue(pos), pos < 3);
+    }
+
+    ASSERT_EQ(dispatcher.size<int>(), 3u);
+    ASSERT_EQ(dispatcher.dropped<int>(), 2u);
+    ASSERT_EQ(rejected, (std::vector<int>{3, 4}));
+
+    ASSERT_EQ(dispatcher.update(2u), 1u);
+    ASSERT_TRUE(dispatcher.enqueue(5));
+    ASSERT_TRUE(dispatcher.enqueue(6));
+    ASSERT_FALSE(dispatcher.enqueue(7));
+
+    dispatcher.update();
+
+    ASSERT_EQ(delivered, (std::vector<int>{0, 1, 2, 5, 6}));
+    ASSERT_EQ(dispatcher.dropped(), 3u);
+
+    dispatcher.bound<int>(0u);
+
+    for(int pos{}; pos < 5; ++pos) {
+        ASSERT_TRUE(dispatcher.enqueue(pos));
+    }
+
+    ASSERT_EQ(dispatcher.size<int>(), 5u);
+    ASSERT_EQ(dispatcher.dropped<another_event>(), 0u);
+}
+
+TEST_CASE("Dispatcher_BoundedDropOldest", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> delivered;
+
+    dispatcher.on<int>([&delivered](int &value) { delivered.push_back(value); });
+    dispatcher.bound<int>(2u, escad::overflow_policy::drop_oldest);
+
+    for(int pos{}; pos < 5; ++pos) {
+        ASSERT_TRUE(dispatcher.enqueue(pos));
+    }
+
+    ASSERT_EQ(dispatcher.size<int>(), 2u);
+    ASSERT_EQ(dispatcher.dropped<int>(), 3u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(delivered, (std::vector<int>{3, 4}));
+
+    dispatcher.on<position>([&delivered](position &event) { delivered.push_back(event.x); });
+    dispatcher.bound<position>(2u, escad::overflow_policy::drop_oldest);
+
+    dispatcher.enqueue(position{1, 10});
+    dispatcher.enqueue(position{2, 20});
+    // coalesced events don't take any room
+    dispatcher.enqueue(position{1, 11});
+    dispatcher.enqueue(position{3, 30});
+    // the dropped event no longer absorbs newer ones
+    dispatcher.enqueue(position{1, 12});
+
+    ASSERT_EQ(dispatcher.size<position>(), 2u);
+    ASSERT_EQ(dispatcher.dropped<position>(), 2u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(delivered, (std::vector<int>{3, 4, 30, 12}));
+}
+
+TEST_CASE("Dispatcher_UpdateParallelGroups", "[Dispatcher]") {
+    escad::dispatcher dispatcher;
+    std::vector<int> delivered;
+    std::size_t tasks{};
+
+    dispatcher.on<int>([&delivered](int &value) { delivered.push_back(value); });
+    dispatcher.on<position>([&delivered](position &event) { delivered.push_back(event.x); });
+    dispatcher.on<an_event>([&delivered](an_event &) { delivered.push_back(0); });
+    dispatcher.group<position>(1u);
+
+    auto inline_executor = [&tasks](escad::delegate<void()> task) {
+        ++tasks;
+        task();
+    };
+
+    dispatcher.enqueue(1);
+    dispatcher.enqueue(position{1, 2});
+    dispatcher.enqueue<an_event>();
+    dispatcher.update_parallel(inline_executor);
+
+    // the calling thread drains one of the two groups
+    ASSERT_EQ(tasks, 1u);
+    ASSERT_EQ(delivered.size(), 3u);
+    ASSERT_EQ(dispatcher.size(), 0u);
+
+    dispatcher.enqueue(3);
+    dispatcher.enqueue(4);
+    dispatcher.update_parallel(inline_executor);
+
+    ASSERT_EQ(tasks, 1u);
+    ASSERT_EQ(delivered.size(), 5u);
+
+    ASSERT_EQ(dispatcher.stats<int>().drains, 2u);
+    ASSERT_EQ(dispatcher.stats<int>().events, 3u);
+    ASSERT_EQ(dispatcher.stats<position>().events, 1u);
+    ASSERT_EQ(dispatcher.stats<an_event>().drains, 1u);
+    ASSERT_EQ(dispatcher.stats<another_event>().drains, 0u);
+
+    dispatcher.update_parallel(inline_executor);
+
+    ASSERT_EQ(dispatcher.stats<int>().drains, 2u);
+
+    dispatcher.reset_stats();
+
+    ASSERT_EQ(dispatcher.stats<int>().events, 0u);
+    ASSERT_EQ(dispatcher.stats<int>().time.count(), 0);
+}
+
+TEST_CASE("Dispatcher_UpdateParallelThreads", "[Dispatcher]") {
+    constexpr std::size_t groups = 4u;
+    constexpr int events = 1000;
+    escad::dispatcher dispatcher;
+    std::vector<std::thread> threads;
+    long long sums[groups]{};
+
+    dispatcher.on<int>([&sums](int &value) { sums[0u] += value; });
+    dispatcher.on<long>([&sums](long &value) { sums[1u] += value; });
+    dispatcher.on<short>([&sums](short &value) { sums[2u] += value; });
+    dispatcher.on<char>([&sums](char &value) { sums[3u] += value; });
+    dispatcher.group<long>(1u);
+    dispatcher.group<short>(2u);
+    dispatcher.group<char>(3u);
+
+    for(int pos{}; pos < events; ++pos) {
+        dispatcher.enqueue(pos);
+        dispatcher.enqueue(static_cast<long>(pos));
+        dispatcher.enqueue(static_cast<short>(pos));
+        dispatcher.enqueue(static_cast<char>(1));
+    }
+
+    dispatcher.update_parallel([&threads](escad::delegate<void()> task) {
+        threads.emplace_back(task);
+    });
+
+    for(auto &&thread: threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(threads.size(), groups - 1u);
+    ASSERT_EQ(dispatcher.size(), 0u);
+    ASSERT_EQ(sums[0u], events * (events - 1) / 2);
+    ASSERT_EQ(sums[1u], sums[0u]);
+    ASSERT_EQ(sums[2u], sums[0u]);
+    ASSERT_EQ(sums[3u], events);
+}
+
+template<std::size_t>
+struct indexed_event {};
+
+template<std::size_t... Value>
+std::vector<escad::id_type> type_indices_from_threads(std::index_sequence<Value...>) {
+    std::vector<escad::id_type> indices(sizeof...(Value));
+    std::vector<std::thread> threads;
+    std::atomic<bool> start{false};
+
+    (threads.emplace_back([&indices, &start]() {
+        while(!start.load()) {}
+        indices[Value] = escad::type_index<indexed_event<Value>>::value();
+    }),
+     ...);
+
+    start.store(true);
+
+    for(auto &&thread: threads) {
+        thread.join();
+    }
+
+    return indices;
+}
+
+TEST_CASE("Dispatcher_TypeIndexFromThreads", "[Dispatcher]") {
+    // queues are looked up by type index, two types sharing one would alias
+    auto indices = type_indices_from_threads(std::make_index_sequence<16u>{});
+    std::sort(indices.begin(), indices.end());
+
+    ASSERT_TRUE(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+}
+
 TEST_CASE("Dispatcher_CustomAllocator", "[Dispatcher]") {
     std::allocator<void> allocator;
     escad::dispatcher dispatcher{allocator};
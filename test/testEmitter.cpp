@@ -1,3 +1,4 @@
+#include <array>
 #include <functional>
 #include <utility>
 
@@ -47,6 +48,28 @@ TEST_CASE("Emitter_Move", "[Emitter]") {
     ASSERT_TRUE(other.empty());
 }
 
+TEST_CASE("Emitter_MoveKeepsListenerState", "[Emitter]") {
+    test_emitter emitter;
+    test_emitter *owner{};
+    int count{};
+
+    emitter.on<foo_event>([&owner, &count, calls = 0](auto &event, auto &ref) mutable {
+        owner = &ref;
+        count = (calls += event.i);
+    });
+
+    emitter.publish(foo_event{1});
+
+    ASSERT_EQ(owner, &emitter);
+    ASSERT_EQ(count, 1);
+
+    test_emitter other{std::move(emitter)};
+    other.publish(foo_event{2});
+
+    ASSERT_EQ(owner, &other);
+    ASSERT_EQ(count, 3);
+}
+
 TEST_CASE("Emitter_Swap", "[Emitter]") {
     test_emitter emitter;
     test_emitter other;
@@ -168,6 +191,59 @@ TEST_CASE("Emitter_OnAndErase", "[Emitter]" ) {
     ASSERT_FALSE(emitter.contains<bar_event>());
 }
 
+TEST_CASE("Emitter_StdFunctionListener", "[Emitter]") {
+    test_emitter emitter;
+    int value{};
+    std::function<void(foo_event &, test_emitter &)> func{[&value](auto &event, auto &) { value = event.i; }};
+
+    emitter.on(std::move(func));
+    emitter.publish(foo_event{42});
+
+    ASSERT_EQ(value, 42);
+}
+
+TEST_CASE("Emitter_LargeListener", "[Emitter]") {
+    test_emitter emitter;
+    std::array<int, 16u> values{};
+    int value{};
+
+    values.back() = 3;
+    emitter.on<foo_event>([values, &value](auto &event, const auto &) { value = event.i * values.back(); });
+
+    test_emitter other{std::move(emitter)};
+    other.publish(foo_event{42});
+
+    ASSERT_EQ(value, 126);
+    ASSERT_TRUE(other.contains<foo_event>());
+}
+
+TEST_CASE("Emitter_OnTwiceAndErase", "[Emitter]") {
+    test_emitter emitter;
+    int value{};
+
+    emitter.on<foo_event>([&value](auto &event, const auto &) { value = event.i; });
+    emitter.on<foo_event>([&value](auto &event, const auto &) { value = -event.i; });
+    emitter.on<bar_event>([](auto &, const auto &) {});
+    emitter.publish(foo_event{42});
+
+    ASSERT_EQ(value, -42);
+
+    emitter.erase<foo_event>();
+    emitter.erase<foo_event>();
+    emitter.erase<quux_event>();
+
+    ASSERT_FALSE(emitter.empty());
+    ASSERT_FALSE(emitter.contains<foo_event>());
+
+    emitter.publish(foo_event{0});
+
+    ASSERT_EQ(value, -42);
+
+    emitter.erase<bar_event>();
+
+    ASSERT_TRUE(emitter.empty());
+}
+
 TEST_CASE("Emitter_CustomAllocator", "[Emitter]") {
     std::allocator<void> allocator;
     test_emitter emitter{allocator};
@@ -10,11 +10,13 @@
  */
 
 #include <iostream>
+#include <vector>
 
 // #include <catch2/catch.hpp>
 #include <base/utils.h>
 #include <catch2/catch_test_macros.hpp>
 #include <fsm/fsm.h>
+#include <signal/dispatcher.h>
 
 
 // events
@@ -145,3 +147,153 @@ TEST_CASE("Simple FSM numeric") {
   REQUIRE(myfsm.NewState.empty());
   REQUIRE_FALSE(conn);
 }
+
+struct RunningObserver {
+  void entered(const Running &) { ++enterCount; }
+
+  void left(const Running &) { ++exitCount; }
+
+  int enterCount{0};
+  int exitCount{0};
+};
+
+TEST_CASE("Simple FSM typed state slots") {
+  Fsm myfsm;
+  RunningObserver observer;
+
+  myfsm.init(Initial{});
+
+  auto enterConn =
+      myfsm.on_enter<Running>().connect<&RunningObserver::entered>(observer);
+  auto exitConn =
+      myfsm.on_exit<Running>().connect<&RunningObserver::left>(observer);
+
+  REQUIRE(enterConn);
+  REQUIRE(exitConn);
+  REQUIRE_FALSE(myfsm.on_enter<Running>().empty());
+  REQUIRE(myfsm.on_enter<Interrupted>().empty());
+
+  myfsm.dispatch(start_event{"Hello!!!"});
+
+  REQUIRE(myfsm.is_state<Running>());
+  REQUIRE(observer.enterCount == 1);
+  REQUIRE(observer.exitCount == 0);
+
+  myfsm.dispatch(stop_event{});
+
+  REQUIRE(myfsm.is_state<Interrupted>());
+  REQUIRE(observer.enterCount == 1);
+  REQUIRE(observer.exitCount == 1);
+
+  // unhandled events do not notify anybody
+  myfsm.dispatch(stop_event{});
+
+  REQUIRE(observer.enterCount == 1);
+  REQUIRE(observer.exitCount == 1);
+
+  enterConn.release();
+  exitConn.release();
+
+  myfsm.dispatch(cont_event{});
+
+  REQUIRE(myfsm.is_state<Running>());
+  REQUIRE(observer.enterCount == 1);
+  REQUIRE(myfsm.on_enter<Running>().empty());
+  REQUIRE(myfsm.on_exit<Running>().empty());
+}
+
+// a state listed twice by the variant shares its slots
+struct flip_event {};
+
+struct LampOff;
+struct LampOn;
+
+using LampStates = std::variant<LampOff, LampOn, LampOff>;
+
+struct LampOff {
+  LampStates transitionTo(const flip_event &);
+};
+
+struct LampOn {
+  LampStates transitionTo(const flip_event &);
+};
+
+LampStates LampOff::transitionTo(const flip_event &) {
+  return LampStates{std::in_place_index<1>};
+}
+
+LampStates LampOn::transitionTo(const flip_event &) {
+  return LampStates{std::in_place_index<2>};
+}
+
+struct LampObserver {
+  void entered(const LampOff &) { ++enterCount; }
+
+  void left(const LampOff &) { ++exitCount; }
+
+  int enterCount{0};
+  int exitCount{0};
+};
+
+TEST_CASE("Simple FSM typed state slots with a repeated state") {
+  escad::fsm::fsm<LampStates> lamp{LampStates{std::in_place_index<0>}};
+  LampObserver observer;
+
+  lamp.on_enter<LampOff>().connect<&LampObserver::entered>(observer);
+  lamp.on_exit<LampOff>().connect<&LampObserver::left>(observer);
+
+  lamp.dispatch(flip_event{});
+
+  REQUIRE(lamp.get_state().index() == 1u);
+  REQUIRE(observer.enterCount == 0);
+  REQUIRE(observer.exitCount == 1);
+
+  lamp.dispatch(flip_event{});
+
+  REQUIRE(lamp.get_state().index() == 2u);
+  REQUIRE(observer.enterCount == 1);
+
+  lamp.dispatch(flip_event{});
+
+  REQUIRE(lamp.get_state().index() == 1u);
+  REQUIRE(observer.exitCount == 2);
+}
+
+struct ChangeRecorder {
+  void receive(const escad::state_change &change) { changes.push_back(change); }
+
+  std::vector<escad::state_change> changes;
+};
+
+TEST_CASE("Simple FSM queued state changes") {
+  Fsm myfsm;
+  escad::dispatcher dispatcher;
+  ChangeRecorder recorder;
+
+  dispatcher.slot<escad::state_change>().connect<&ChangeRecorder::receive>(
+      recorder);
+
+  myfsm.init(Initial{});
+  myfsm.connect_changes(dispatcher, 7u);
+
+  myfsm.dispatch(start_event{"Hello!!!"});
+  myfsm.dispatch(stop_event{});
+
+  REQUIRE(myfsm.is_state<Interrupted>());
+  REQUIRE(dispatcher.size<escad::state_change>() == 2u);
+  REQUIRE(recorder.changes.empty());
+
+  dispatcher.update();
+
+  REQUIRE(recorder.changes.size() == 2u);
+  REQUIRE(recorder.changes[0].machine == 7u);
+  REQUIRE(recorder.changes[0].from == state{Initial{}}.index());
+  REQUIRE(recorder.changes[0].to == state{Running{}}.index());
+  REQUIRE(recorder.changes[1].from == state{Running{}}.index());
+  REQUIRE(recorder.changes[1].to == state{Interrupted{}}.index());
+
+  myfsm.disconnect_changes();
+  myfsm.dispatch(cont_event{});
+
+  REQUIRE(dispatcher.size() == 0u);
+}
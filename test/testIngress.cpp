@@ -0,0 +1,138 @@
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <variant>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <base/hashed_string.h>
+#include <fsm/fsm.h>
+#include <fsm/ingress.h>
+
+using namespace escad::literals;
+
+namespace {
+
+struct start {
+  int speed;
+};
+
+struct stop {};
+
+struct setpoint {
+  int value;
+};
+
+// payload is a single byte, the setpoint in percent
+struct setpoint_decoder {
+  std::optional<setpoint> operator()(const std::byte *data,
+                                     std::size_t size) const noexcept {
+    if (size != 1u || std::to_integer<int>(data[0]) > 100) {
+      return std::nullopt;
+    }
+
+    return setpoint{std::to_integer<int>(data[0])};
+  }
+};
+
+int moving_speed{};
+
+struct Idle;
+
+struct Moving {
+  void onEnter(const start &event) { moving_speed = event.speed; }
+
+  auto transitionTo(const stop &);
+};
+
+struct Idle {
+  auto transitionTo(const start &);
+};
+
+auto Moving::transitionTo(const stop &) { return Idle{}; }
+
+auto Idle::transitionTo(const start &) { return Moving{}; }
+
+struct Recorder {
+  template <typename Event> bool dispatch(const Event &) { return false; }
+
+  bool dispatch(const setpoint &event) {
+    value = event.value;
+    return event.value != 0;
+  }
+
+  int value{-1};
+};
+
+using protocol = escad::ingress<
+    escad::ingress_event<"stop"_hs, stop, escad::trivial_decoder<stop>>,
+    escad::ingress_event<"start"_hs, start>,
+    escad::ingress_event<0x10u, setpoint, setpoint_decoder>>;
+
+template <typename Event> auto bytes(const Event &event) {
+  std::array<std::byte, sizeof(Event)> buffer{};
+  std::memcpy(buffer.data(), &event, sizeof(Event));
+  return buffer;
+}
+
+} // namespace
+
+TEST_CASE("Ingress lookup") {
+  static_assert(protocol::contains("start"_hs));
+  static_assert(protocol::contains(0x10u));
+
+  REQUIRE(protocol::contains("stop"_hs));
+  REQUIRE_FALSE(protocol::contains("pause"_hs));
+}
+
+TEST_CASE("Ingress dispatch_raw into fsm") {
+  escad::fsm::fsm<std::variant<Idle, Moving>> machine;
+
+  const auto payload = bytes(start{42});
+
+  REQUIRE(protocol::dispatch_raw(machine, "start"_hs, payload.data(),
+                                 payload.size()) ==
+          escad::ingress_result::dispatched);
+  REQUIRE(machine.is_state<Moving>());
+  REQUIRE(moving_speed == 42);
+
+  REQUIRE(protocol::dispatch_raw(machine, "stop"_hs, payload.data(), 3u) ==
+          escad::ingress_result::malformed);
+  REQUIRE(machine.is_state<Moving>());
+
+  REQUIRE(protocol::dispatch_raw(machine, "pause"_hs, nullptr, 0u) ==
+          escad::ingress_result::unknown_id);
+  REQUIRE(machine.is_state<Moving>());
+
+  const auto empty = bytes(stop{});
+
+  REQUIRE(protocol::dispatch_raw(machine, "stop"_hs, empty.data(),
+                                 empty.size()) ==
+          escad::ingress_result::dispatched);
+  REQUIRE(machine.is_state<Idle>());
+}
+
+TEST_CASE("Ingress custom decoder and dispatch result") {
+  Recorder recorder;
+  std::array<std::byte, 1u> payload{std::byte{75}};
+
+  REQUIRE(protocol::dispatch_raw(recorder, 0x10u, payload.data(),
+                                 payload.size()) ==
+          escad::ingress_result::dispatched);
+  REQUIRE(recorder.value == 75);
+
+  payload[0] = std::byte{0};
+
+  REQUIRE(protocol::dispatch_raw(recorder, 0x10u, payload.data(),
+                                 payload.size()) ==
+          escad::ingress_result::unhandled);
+  REQUIRE(recorder.value == 0);
+
+  payload[0] = std::byte{101};
+
+  REQUIRE(protocol::dispatch_raw(recorder, 0x10u, payload.data(),
+                                 payload.size()) ==
+          escad::ingress_result::malformed);
+  REQUIRE(recorder.value == 0);
+}
@@ -0,0 +1,129 @@
+#include <array>
+#include <memory>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <signal/inplace_delegate.h>
+#include <signal/signal.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+namespace {
+
+int power_of_two(int value) {
+    return value * value;
+}
+
+struct tracker {
+    explicit tracker(int &count)
+        : alive{&count} {
+        ++*alive;
+    }
+
+    tracker(tracker &&other) noexcept
+        : alive{other.alive} {
+        ++*alive;
+    }
+
+    ~tracker() {
+        --*alive;
+    }
+
+    int operator()(int value) const {
+        return value + *alive;
+    }
+
+    int *alive;
+};
+
+} // namespace
+
+TEST_CASE("InplaceDelegate_Functionalities", "[InplaceDelegate]") {
+    escad::inplace_delegate<int(int)> delegate;
+
+    ASSERT_FALSE(delegate);
+
+    delegate = escad::inplace_delegate<int(int)>{&power_of_two};
+
+    ASSERT_TRUE(delegate);
+    ASSERT_EQ(delegate(3), 9);
+
+    int offset = 2;
+    delegate.emplace([offset](int value) { return value + offset; });
+
+    ASSERT_EQ(delegate(3), 5);
+
+    delegate.reset();
+
+    ASSERT_FALSE(delegate);
+}
+
+TEST_CASE("InplaceDelegate_OwnsState", "[InplaceDelegate]") {
+    escad::inplace_delegate<int()> delegate{[counter = 0]() mutable { return ++counter; }};
+
+    ASSERT_EQ(delegate(), 1);
+    ASSERT_EQ(delegate(), 2);
+
+    escad::inplace_delegate<int()> other{std::move(delegate)};
+
+    ASSERT_FALSE(delegate);
+    ASSERT_EQ(other(), 3);
+}
+
+TEST_CASE("InplaceDelegate_Lifetime", "[InplaceDelegate]") {
+    int alive{};
+
+    {
+        escad::inplace_delegate<int(int)> delegate{tracker{alive}};
+
+        ASSERT_EQ(alive, 1);
+        ASSERT_EQ(delegate(1), 2);
+
+        escad::inplace_delegate<int(int)> other;
+        other = std::move(delegate);
+
+        ASSERT_EQ(alive, 1);
+        ASSERT_FALSE(delegate);
+        ASSERT_TRUE(other);
+
+        other.emplace(&power_of_two);
+
+        ASSERT_EQ(alive, 0);
+
+        other.emplace(tracker{alive});
+    }
+
+    ASSERT_EQ(alive, 0);
+}
+
+TEST_CASE("InplaceDelegate_MoveOnlyCallable", "[InplaceDelegate]") {
+    auto ptr = std::make_unique<int>(42);
+    escad::inplace_delegate<int()> delegate{[ptr = std::move(ptr)]() { return *ptr; }};
+
+    ASSERT_EQ(delegate(), 42);
+}
+
+TEST_CASE("InplaceDelegate_CustomSize", "[InplaceDelegate]") {
+    std::array<int, 16u> values{};
+    values[15u] = 3;
+
+    escad::inplace_delegate<int(), sizeof(values)> delegate{[values]() { return values[15u]; }};
+
+    ASSERT_EQ(decltype(delegate)::inline_size, sizeof(values));
+    ASSERT_EQ(delegate(), 3);
+}
+
+TEST_CASE("InplaceDelegate_Signal", "[InplaceDelegate]") {
+    escad::signal<void(int)> signal;
+    escad::slot slot{signal};
+    int sum{};
+
+    escad::inplace_delegate<void(int)> listener{[&sum](int value) { sum += value; }};
+    slot.connect<&escad::inplace_delegate<void(int)>::operator()>(listener);
+    signal.publish(2);
+
+    ASSERT_EQ(sum, 2);
+}
@@ -0,0 +1,48 @@
+#include <memory>
+
+#define FSM_ALLOCATION_HOOK_IMPLEMENTATION
+#include "allocations.h"
+
+#include <new_fsm/state.h>
+#include <new_fsm/state_machine.h>
+
+using namespace escad::new_fsm;
+
+namespace {
+
+struct toggle {};
+
+struct Off;
+
+struct On : state<On> {
+  using state::state;
+
+  auto transitionTo(const toggle &) { return sibling<Off>(); }
+};
+
+struct Off : state<Off> {
+  using state::state;
+
+  auto transitionTo(const toggle &) { return sibling<On>(); }
+};
+
+using context = detail::NoContext;
+using machine_type = StateMachine<states<Off, On>, context>;
+
+} // namespace
+
+TEST_CASE("StateMachine dispatch does not allocate") {
+  auto machine = std::make_unique<machine_type>(
+      mpl::type_identity<states<Off, On>>{}, context{});
+  machine->emplace<Off>();
+
+  REQUIRE_NO_ALLOCATIONS(REQUIRE(machine->dispatch(toggle{})));
+  REQUIRE(machine->is_in<On>());
+  REQUIRE_NO_ALLOCATIONS(REQUIRE(machine->dispatch(toggle{})));
+  REQUIRE(machine->is_in<Off>());
+
+  REQUIRE_NO_ALLOCATIONS(for (int pos{}; pos < 100; ++pos) {
+    machine->dispatch(toggle{});
+  });
+  REQUIRE(machine->is_in<Off>());
+}
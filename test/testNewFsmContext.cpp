@@ -3,6 +3,7 @@
 #include <iostream>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <ctre.hpp>
@@ -10,6 +11,7 @@
 #include "base/utils.h"
 
 #include <new_fsm/state_machine.h>
+#include <signal/dispatcher.h>
 
 #include "flat_fsm.h"
 
@@ -169,3 +171,52 @@ TEST_CASE("Context implicit", "[new_fsm]") {
   REQUIRE_FALSE(fsm.context().is_valid());
   REQUIRE(fsm.context().value() == 10);
 }
+
+struct change_recorder {
+  void receive(const escad::state_change &change) { changes.push_back(change); }
+
+  std::vector<escad::state_change> changes;
+};
+
+TEST_CASE("Context queued state changes", "[new_fsm]") {
+
+  flat::Context ctx_;
+  escad::dispatcher dispatcher;
+  change_recorder recorder;
+
+  dispatcher.slot<escad::state_change>().connect<&change_recorder::receive>(
+      recorder);
+
+  auto fsm = StateMachine(mpl::type_identity<flat::States>{}, ctx_);
+  fsm.connect_changes(dispatcher, 42u);
+
+  fsm.emplace<flat::Initial>();
+  fsm.dispatch(flat::event1{});
+  fsm.dispatch(flat::event2{2});
+
+  REQUIRE(fsm.is_in<flat::Third>());
+  REQUIRE(dispatcher.size<escad::state_change>() == 3u);
+  REQUIRE(recorder.changes.empty());
+
+  dispatcher.update();
+
+  using variant = decltype(fsm)::states_variant_list;
+
+  REQUIRE(recorder.changes.size() == 3u);
+  REQUIRE(recorder.changes[0].machine == 42u);
+  REQUIRE(recorder.changes[0].from == 0u);
+  REQUIRE(recorder.changes[0].to ==
+          mpl::type_list_index_v<flat::Initial, variant>);
+  REQUIRE(recorder.changes[1].from ==
+          mpl::type_list_index_v<flat::Initial, variant>);
+  REQUIRE(recorder.changes[1].to ==
+          mpl::type_list_index_v<flat::Second, variant>);
+  REQUIRE(recorder.changes[2].to ==
+          mpl::type_list_index_v<flat::Third, variant>);
+  REQUIRE(recorder.changes[1].timestamp <= recorder.changes[2].timestamp);
+
+  fsm.disconnect_changes();
+  fsm.emplace<flat::Initial>();
+
+  REQUIRE(dispatcher.size() == 0u);
+}
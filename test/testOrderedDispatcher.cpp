@@ -0,0 +1,369 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <base/hashed_string.h>
+#include <signal/ordered_dispatcher.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+struct small_event {
+    char value;
+};
+
+struct wide_event {
+    double value;
+    std::uint64_t padding;
+};
+
+// makes the type non-aggregate
+struct text_event {
+    explicit text_event(std::string str)
+        : text{std::move(str)} {}
+
+    std::string text;
+};
+
+struct recorder {
+    void small(small_event &event) {
+        log.push_back("s" + std::to_string(event.value));
+    }
+
+    void wide(wide_event &event) {
+        log.push_back("w" + std::to_string(static_cast<int>(event.value)));
+    }
+
+    void text(text_event &event) {
+        log.push_back(event.text);
+    }
+
+    std::vector<std::string> log;
+};
+
+template<typename Dispatcher>
+void connect(Dispatcher &dispatcher, recorder &rec) {
+    dispatcher.template slot<small_event>().template connect<&recorder::small>(rec);
+    dispatcher.template slot<wide_event>().template connect<&recorder::wide>(rec);
+    dispatcher.template slot<text_event>().template connect<&recorder::text>(rec);
+}
+
+TEST_CASE("OrderedDispatcher_Order", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    recorder rec;
+
+    connect(dispatcher, rec);
+
+    dispatcher.enqueue<small_event>(char{1});
+    dispatcher.enqueue(wide_event{2., 0u});
+    dispatcher.enqueue<text_event>("three");
+    dispatcher.enqueue(small_event{4});
+    dispatcher.enqueue<wide_event>(5., std::uint64_t{});
+
+    ASSERT_EQ(dispatcher.size(), 5u);
+    ASSERT_EQ(dispatcher.size<small_event>(), 2u);
+    ASSERT_EQ(dispatcher.size<text_event>(), 1u);
+
+    dispatcher.update();
+
+    const std::vector<std::string> expected{"s1", "w2", "three", "s4", "w5"};
+
+    ASSERT_EQ(rec.log, expected);
+    ASSERT_EQ(dispatcher.size(), 0u);
+    ASSERT_EQ(dispatcher.size<small_event>(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_TriggerAndNamedQueue", "[OrderedDispatcher]") {
+    using namespace escad::literals;
+
+    escad::ordered_dispatcher dispatcher;
+    recorder rec;
+    recorder named;
+
+    connect(dispatcher, rec);
+    dispatcher.slot<small_event>("named"_hs).connect<&recorder::small>(named);
+
+    dispatcher.trigger(small_event{1});
+    dispatcher.trigger("named"_hs, small_event{2});
+
+    ASSERT_EQ(rec.log.size(), 1u);
+    ASSERT_EQ(named.log.size(), 1u);
+
+    dispatcher.enqueue_hint<small_event>("named"_hs, char{3});
+    dispatcher.enqueue(small_event{4});
+    dispatcher.enqueue_hint("named"_hs, small_event{5});
+    dispatcher.update();
+
+    ASSERT_EQ(rec.log.back(), "s4");
+    ASSERT_EQ(named.log.back(), "s5");
+    ASSERT_EQ(named.log.size(), 3u);
+
+    dispatcher.disconnect(rec);
+    dispatcher.trigger(small_event{6});
+
+    ASSERT_EQ(rec.log.size(), 2u);
+}
+
+TEST_CASE("OrderedDispatcher_WrapAndGrow", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    recorder rec;
+    connect(dispatcher, rec);
+
+    std::vector<std::string> expected;
+    int next{};
+
+    // steady state with a partially consumed buffer wraps around its end
+    for(int round{}; round < 64; ++round) {
+        for(int pos{}; pos < round % 7 + 1; ++pos, ++next) {
+            switch(next % 3) {
+            case 0:
+                dispatcher.enqueue(small_event{static_cast<char>(next % 100)});
+                expected.push_back("s" + std::to_string(next % 100));
+                break;
+            case 1:
+                dispatcher.enqueue(wide_event{static_cast<double>(next), 0u});
+                expected.push_back("w" + std::to_string(next));
+                break;
+            default:
+                // long enough to defeat the small string optimization
+                dispatcher.enqueue<text_event>(std::string(32u, 'a') + std::to_string(next));
+                expected.push_back(std::string(32u, 'a') + std::to_string(next));
+                break;
+            }
+        }
+
+        if(round % 3 != 2) {
+            dispatcher.update();
+        }
+    }
+
+    dispatcher.update();
+
+    ASSERT_EQ(rec.log, expected);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_EnqueueFromListener", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    std::vector<std::string> log;
+
+    struct forwarder {
+        void receive(text_event &event) {
+            log->push_back(event.text);
+
+            if(event.text.size() < 40u) {
+                // forwards the event being delivered while the buffer grows
+                for(int pos{}; pos < 16; ++pos) {
+                    dispatcher->enqueue(text_event{event.text + "+"});
+                }
+
+                dispatcher->enqueue(event);
+            }
+        }
+
+        escad::ordered_dispatcher *dispatcher;
+        std::vector<std::string> *log;
+    } fwd{&dispatcher, &log};
+
+    dispatcher.slot<text_event>().connect<&forwarder::receive>(fwd);
+    dispatcher.enqueue<text_event>(std::string(32u, 'x'));
+    dispatcher.update();
+
+    ASSERT_EQ(log.size(), 1u);
+    ASSERT_EQ(dispatcher.size(), 17u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(log.size(), 18u);
+    ASSERT_EQ(log.back(), std::string(32u, 'x'));
+}
+
+TEST_CASE("OrderedDispatcher_WrapShortTail", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    std::vector<int> log;
+
+    struct forwarder {
+        void receive(int &value) {
+            log->push_back(value);
+
+            if(value == 1) {
+                // 12 byte records leave a tail shorter than a record header
+                for(int pos{}; pos < 20; ++pos) {
+                    dispatcher->enqueue(pos + 2);
+                }
+            }
+        }
+
+        escad::ordered_dispatcher *dispatcher;
+        std::vector<int> *log;
+    } fwd{&dispatcher, &log};
+
+    dispatcher.slot<int>().connect<&forwarder::receive>(fwd);
+    dispatcher.enqueue(0);
+    dispatcher.enqueue(1);
+    dispatcher.update();
+
+    ASSERT_EQ(dispatcher.capacity_bytes(), 256u);
+    ASSERT_EQ(dispatcher.size(), 20u);
+
+    dispatcher.update();
+    dispatcher.enqueue(22);
+    dispatcher.update();
+
+    ASSERT_EQ(log.size(), 23u);
+
+    for(int pos{}; pos < 23; ++pos) {
+        ASSERT_EQ(log[static_cast<std::size_t>(pos)], pos);
+    }
+
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_Clear", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    recorder rec;
+    connect(dispatcher, rec);
+
+    dispatcher.enqueue(small_event{1});
+    dispatcher.enqueue<text_event>("two");
+    dispatcher.enqueue(small_event{3});
+    dispatcher.enqueue<text_event>("four");
+    dispatcher.clear<small_event>();
+
+    ASSERT_EQ(dispatcher.size(), 2u);
+    ASSERT_EQ(dispatcher.size<small_event>(), 0u);
+
+    dispatcher.update();
+
+    const std::vector<std::string> expected{"two", "four"};
+
+    ASSERT_EQ(rec.log, expected);
+
+    dispatcher.enqueue(small_event{5});
+    dispatcher.clear();
+
+    ASSERT_EQ(dispatcher.size(), 0u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(rec.log, expected);
+}
+
+TEST_CASE("OrderedDispatcher_ClearFromListener", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    int count{};
+
+    struct clearing {
+        void receive(small_event &event) {
+            ++*count;
+
+            if(event.value == 1) {
+                dispatcher->clear<small_event>();
+                dispatcher->enqueue(small_event{9});
+            }
+        }
+
+        escad::ordered_dispatcher *dispatcher;
+        int *count;
+    } listener{&dispatcher, &count};
+
+    dispatcher.slot<small_event>().connect<&clearing::receive>(listener);
+    dispatcher.enqueue(small_event{1});
+    dispatcher.enqueue(small_event{2});
+    dispatcher.enqueue(small_event{3});
+    dispatcher.update();
+
+    ASSERT_EQ(count, 1);
+    ASSERT_EQ(dispatcher.size(), 1u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_ClearAllFromLastListener", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    int count{};
+
+    struct clearing {
+        void receive(small_event &event) {
+            ++*count;
+
+            if(event.value == 2) {
+                dispatcher->clear();
+                dispatcher->enqueue(small_event{9});
+            }
+        }
+
+        escad::ordered_dispatcher *dispatcher;
+        int *count;
+    } listener{&dispatcher, &count};
+
+    dispatcher.slot<small_event>().connect<&clearing::receive>(listener);
+    dispatcher.enqueue(small_event{1});
+    dispatcher.enqueue(small_event{2});
+    dispatcher.update();
+
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(dispatcher.size(), 1u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_ClearEnqueuedFromLastListener", "[OrderedDispatcher]") {
+    escad::ordered_dispatcher dispatcher;
+    recorder rec;
+
+    struct clearing {
+        void receive(small_event &event) {
+            if(event.value == 2) {
+                dispatcher->enqueue(wide_event{7.0, 0u});
+                dispatcher->clear<wide_event>();
+                dispatcher->enqueue(text_event{"t"});
+            }
+        }
+
+        escad::ordered_dispatcher *dispatcher;
+    } listener{&dispatcher};
+
+    connect(dispatcher, rec);
+    dispatcher.slot<small_event>().connect<&clearing::receive>(listener);
+    dispatcher.enqueue(small_event{1});
+    dispatcher.enqueue(small_event{2});
+    dispatcher.update();
+
+    ASSERT_EQ(rec.log, (std::vector<std::string>{"s1", "s2"}));
+    ASSERT_EQ(dispatcher.size(), 1u);
+    ASSERT_EQ(dispatcher.size<wide_event>(), 0u);
+
+    dispatcher.update();
+
+    ASSERT_EQ(rec.log, (std::vector<std::string>{"s1", "s2", "t"}));
+    ASSERT_EQ(dispatcher.size(), 0u);
+}
+
+TEST_CASE("OrderedDispatcher_PendingEventsAreDestroyed", "[OrderedDispatcher]") {
+    auto value = std::make_shared<int>(0);
+
+    {
+        escad::ordered_dispatcher dispatcher;
+        dispatcher.enqueue(value);
+        dispatcher.enqueue(value);
+        dispatcher.reserve_bytes(4096u);
+
+        ASSERT_TRUE(dispatcher.capacity_bytes() >= 4096u);
+        ASSERT_EQ(value.use_count(), 3);
+        ASSERT_EQ(dispatcher.size(), 2u);
+    }
+
+    ASSERT_EQ(value.use_count(), 1);
+}
@@ -0,0 +1,171 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <signal/concurrent_dispatcher.h>
+#include <signal/dispatcher.h>
+#include <signal/reactor.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+struct an_event {
+    int value;
+};
+
+struct counter {
+    void notify() {
+        ++cnt;
+    }
+
+    void receive(an_event &event) {
+        sum += event.value;
+    }
+
+    int cnt{0};
+    int sum{0};
+};
+
+TEST_CASE("Reactor_NotifierIsEdgeTriggered", "[Reactor]") {
+    escad::dispatcher dispatcher;
+    counter counter;
+
+    dispatcher.notifier({escad::connect_arg<&counter::notify>, counter});
+
+    ASSERT_EQ(counter.cnt, 0);
+
+    dispatcher.enqueue(an_event{1});
+    dispatcher.enqueue(an_event{2});
+    dispatcher.enqueue(an_event{3});
+
+    ASSERT_EQ(counter.cnt, 1);
+
+    dispatcher.update();
+    dispatcher.enqueue(an_event{4});
+
+    ASSERT_EQ(counter.cnt, 2);
+
+    // events left behind are notified again
+    dispatcher.enqueue(an_event{5});
+    ASSERT_EQ(dispatcher.update(1u), 1u);
+    ASSERT_EQ(counter.cnt, 3);
+
+    dispatcher.enqueue(an_event{6});
+    ASSERT_EQ(counter.cnt, 3);
+
+    dispatcher.clear();
+    dispatcher.enqueue(an_event{7});
+    ASSERT_EQ(counter.cnt, 4);
+
+    dispatcher.notifier({});
+    dispatcher.update();
+    dispatcher.enqueue(an_event{8});
+    ASSERT_EQ(counter.cnt, 4);
+
+    // pending events are notified right away
+    dispatcher.notifier({escad::connect_arg<&counter::notify>, counter});
+    ASSERT_EQ(counter.cnt, 5);
+}
+
+TEST_CASE("Reactor_EventfdNotifier", "[Reactor]") {
+    escad::eventfd_notifier notifier;
+
+    ASSERT_TRUE(notifier);
+    ASSERT_FALSE(notifier.consume());
+
+    notifier.notify();
+    notifier.notify();
+
+    ASSERT_TRUE(notifier.consume());
+    ASSERT_FALSE(notifier.consume());
+}
+
+TEST_CASE("Reactor_DrainsDispatcher", "[Reactor]") {
+    escad::dispatcher dispatcher;
+    escad::reactor reactor{dispatcher, 2u};
+    counter counter;
+
+    dispatcher.slot<an_event>().connect<&counter::receive>(counter);
+
+    // nothing to do, the timeout expires
+    ASSERT_EQ(reactor.poll(0), 0u);
+
+    for(int pos{}; pos < 5; ++pos) {
+        dispatcher.enqueue(an_event{1});
+    }
+
+    ASSERT_EQ(reactor.poll(), 3u);
+    ASSERT_EQ(reactor.poll(), 1u);
+    ASSERT_EQ(reactor.poll(), 0u);
+    ASSERT_EQ(counter.sum, 5);
+}
+
+TEST_CASE("Reactor_WatchesDescriptors", "[Reactor]") {
+    escad::dispatcher dispatcher;
+    escad::reactor reactor{dispatcher};
+    std::vector<std::uint32_t> seen;
+    int fds[2];
+
+    ASSERT_EQ(::pipe(fds), 0);
+
+    ASSERT_TRUE(reactor.watch(fds[0], EPOLLIN, [&reactor, &seen, fd = fds[0]](std::uint32_t events) {
+        char value{};
+        static_cast<void>(::read(fd, &value, 1u));
+        seen.push_back(events);
+        reactor.unwatch(fd);
+    }));
+
+    ASSERT_FALSE(reactor.watch(fds[0], EPOLLIN, [](std::uint32_t) {}));
+    ASSERT_EQ(::write(fds[1], "x", 1u), 1);
+
+    reactor.poll();
+
+    ASSERT_EQ(seen.size(), 1u);
+    ASSERT_TRUE(seen[0] & EPOLLIN);
+
+    ASSERT_EQ(::write(fds[1], "x", 1u), 1);
+    reactor.poll(0);
+
+    ASSERT_EQ(seen.size(), 1u);
+    ASSERT_FALSE(reactor.unwatch(fds[0]));
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("Reactor_WakesUpConsumer", "[Reactor]") {
+    constexpr int events = 10000;
+
+    escad::concurrent_dispatcher dispatcher;
+    escad::reactor reactor{dispatcher};
+    counter counter;
+
+    dispatcher.slot<an_event>().connect<&counter::receive>(counter);
+    dispatcher.slot<int>().connect<&escad::reactor<escad::concurrent_dispatcher>::stop>(reactor);
+    dispatcher.freeze();
+
+    std::thread producer{[&dispatcher]() {
+        for(int pos{}; pos < events; ++pos) {
+            dispatcher.enqueue(an_event{1});
+
+            if(pos % 1000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        dispatcher.enqueue(0);
+    }};
+
+    reactor.run();
+    producer.join();
+    dispatcher.update();
+
+    ASSERT_EQ(counter.sum, events);
+}
@@ -8,8 +8,11 @@
  * @copyright Copyright (c) 2022
  * 
  */
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 //#include <catch2/catch.hpp>
 #include <catch2/catch_all.hpp>
@@ -284,6 +287,76 @@ TEST_CASE("SignalSlot_CollectorVoid" , "[SignalSlot]") {
     REQUIRE(cnt == 1);
 }
 
+TEST_CASE("SignalSlot_PublishBatch", "[SignalSlot]") {
+    escad::signal<void(const int &)> sigh;
+    escad::slot sink{sigh};
+    std::vector<const int *> seen;
+    std::vector<int> order;
+
+    struct recorder {
+        void first(const int &value) {
+            order->push_back(value);
+            seen->push_back(&value);
+        }
+
+        void second(const int &value) {
+            order->push_back(-value);
+        }
+
+        std::vector<int> *order;
+        std::vector<const int *> *seen;
+    } instance{&order, &seen};
+
+    sink.connect<&recorder::first>(instance);
+    sink.connect<&recorder::second>(instance);
+
+    const std::vector<int> values{1, 2, 3};
+    sigh.publish_batch(values);
+
+    // listeners handle the whole batch in turn, elements are never copied
+    REQUIRE(order == std::vector<int>{1, 2, 3, -1, -2, -3});
+    REQUIRE(seen == std::vector<const int *>{&values[0], &values[1], &values[2]});
+
+    order.clear();
+    sigh.publish_batch(values.begin() + 1, values.end());
+
+    REQUIRE(order == std::vector<int>{2, 3, -2, -3});
+
+    escad::signal<void(int &)> mutating;
+    escad::slot{mutating}.connect<&sigh_listener::f>();
+    std::vector<int> targets(3u, 0);
+
+    mutating.publish_batch(targets.begin(), targets.end());
+
+    REQUIRE(targets == std::vector<int>{42, 42, 42});
+}
+
+TEST_CASE("SignalSlot_CollectBatch", "[SignalSlot]") {
+    sigh_listener listener;
+    escad::signal<bool(int)> sigh;
+    escad::slot sink{sigh};
+    std::vector<bool> collected;
+
+    sink.connect<&sigh_listener::g>(listener);
+    sink.connect<&sigh_listener::h>(listener);
+
+    const int values[]{1, 2, 3};
+    sigh.collect_batch([&collected](bool value) { collected.push_back(value); }, values);
+
+    REQUIRE(collected == std::vector<bool>{true, true, true, true, true, true});
+    REQUIRE(listener.k);
+
+    int cnt{};
+    sigh.collect_batch([&cnt](bool) { return ++cnt == 2; }, std::begin(values), std::end(values));
+
+    REQUIRE(cnt == 2);
+
+    escad::signal<void(int)> empty;
+    empty.collect_batch([&cnt]() { ++cnt; }, values);
+
+    REQUIRE(cnt == 2);
+}
+
 TEST_CASE("SignalSlot_Connection", "[SignalSlot]") {
     escad::signal<void(int &)> sigh;
     escad::slot sink{sigh};
@@ -589,3 +662,191 @@ TEST_CASE("SignalSlot_CustomAllocator", "[SignalSlot]") {
     REQUIRE(move.empty());
 }
 
+
+struct ordered_listener {
+    void call(std::vector<int> &order) {
+        order.push_back(id);
+    }
+
+    int id{};
+};
+
+TEST_CASE("SignalSlot_ConnectionReleaseKeepsOrder", "[SignalSlot]") {
+    escad::signal<void(std::vector<int> &)> sigh;
+    escad::slot sink{sigh};
+    std::vector<ordered_listener> listeners(8u);
+    std::vector<escad::connection> conns;
+    std::vector<int> order;
+
+    for (int i = 0; i < 8; ++i) {
+        listeners[i].id = i;
+        conns.push_back(sink.connect<&ordered_listener::call>(listeners[i]));
+    }
+
+    conns[1].release();
+    conns[4].release();
+
+    REQUIRE(sigh.size() == 6u);
+
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{0, 2, 3, 5, 6, 7});
+
+    // compacts the listeners, the remaining connections stay valid
+    conns[0].release();
+    conns[2].release();
+    conns[6].release();
+
+    REQUIRE(sigh.size() == 3u);
+
+    order.clear();
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{3, 5, 7});
+
+    conns[5].release();
+    order.clear();
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{3, 7});
+
+    sink.before(listeners[7]).connect<&ordered_listener::call>(listeners[1]);
+    order.clear();
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{3, 1, 7});
+}
+
+TEST_CASE("SignalSlot_StaleConnection", "[SignalSlot]") {
+    escad::signal<void(std::vector<int> &)> sigh;
+    escad::slot sink{sigh};
+    ordered_listener listener{3};
+    std::vector<int> order;
+
+    auto stale = sink.connect<&ordered_listener::call>(listener);
+    sink.disconnect(listener);
+    auto fresh = sink.connect<&ordered_listener::call>(listener);
+
+    // the key of the first connection is outdated, nothing happens
+    stale.release();
+
+    REQUIRE(sigh.size() == 1u);
+
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{3});
+
+    sink.disconnect();
+    fresh.release();
+
+    REQUIRE(sigh.empty());
+}
+
+TEST_CASE("SignalSlot_ConnectUnchecked", "[SignalSlot]") {
+    escad::signal<void(std::vector<int> &)> sigh;
+    escad::slot sink{sigh};
+    ordered_listener listener{5};
+    std::vector<int> order;
+
+    auto first = sink.connect_unchecked<&ordered_listener::call>(listener);
+    sink.connect_unchecked<&ordered_listener::call>(listener);
+
+    REQUIRE(sigh.size() == 2u);
+
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{5, 5});
+
+    first.release();
+    order.clear();
+    sigh.publish(order);
+
+    REQUIRE(sigh.size() == 1u);
+    REQUIRE(order == std::vector<int>{5});
+
+    // connect still drops every previous connection
+    sink.connect<&ordered_listener::call>(listener);
+
+    REQUIRE(sigh.size() == 1u);
+}
+
+TEST_CASE("SignalSlot_ConnectionChurn", "[SignalSlot]") {
+    constexpr std::size_t count = 64u;
+
+    escad::signal<void(std::vector<int> &)> sigh;
+    escad::slot sink{sigh};
+    std::vector<ordered_listener> listeners(count);
+    std::vector<escad::connection> conns(count);
+    std::vector<bool> connected(count);
+    std::vector<int> expected;
+    std::vector<int> order;
+    std::uint32_t seed = 7u;
+
+    for (std::size_t pos{}; pos < count; ++pos) {
+        listeners[pos].id = static_cast<int>(pos);
+    }
+
+    for (int step{}; step < 4000; ++step) {
+        seed = seed * 1664525u + 1013904223u;
+        const auto pos = (seed >> 8u) % count;
+        const auto id = static_cast<int>(pos);
+
+        if (connected[pos]) {
+            conns[pos].release();
+            expected.erase(std::find(expected.begin(), expected.end(), id));
+        } else if (!expected.empty() && (seed >> 24u) % 4u == 0u) {
+            // before a listener already connected, the dense array shifts
+            const auto other = expected[(seed >> 16u) % expected.size()];
+            conns[pos] = sink.before(listeners[static_cast<std::size_t>(other)]).connect_unchecked<&ordered_listener::call>(listeners[pos]);
+            expected.insert(std::find(expected.begin(), expected.end(), other), id);
+        } else {
+            conns[pos] = sink.connect_unchecked<&ordered_listener::call>(listeners[pos]);
+            expected.push_back(id);
+        }
+
+        connected[pos] = !connected[pos];
+        order.clear();
+        sigh.publish(order);
+
+        REQUIRE(sigh.size() == expected.size());
+        REQUIRE(order == expected);
+    }
+}
+
+TEST_CASE("SignalSlot_SmallSignal", "[SignalSlot]") {
+    escad::small_signal<void(std::vector<int> &), 2u> sigh;
+    escad::slot sink{sigh};
+    ordered_listener first{1};
+    ordered_listener second{2};
+    ordered_listener third{3};
+    std::vector<int> order;
+
+    REQUIRE(sigh.empty());
+
+    auto conn = sink.connect<&ordered_listener::call>(first);
+    sink.connect<&ordered_listener::call>(third);
+    sink.before(third).connect<&ordered_listener::call>(second);
+
+    REQUIRE(sigh.size() == 3u);
+
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{1, 2, 3});
+
+    decltype(sigh) copy{sigh};
+    conn.release();
+    sink.disconnect(third);
+
+    REQUIRE(sigh.size() == 1u);
+    REQUIRE(copy.size() == 3u);
+
+    sigh = std::move(copy);
+    order.clear();
+    sigh.publish(order);
+
+    REQUIRE(order == std::vector<int>{1, 2, 3});
+
+    sink.disconnect();
+
+    REQUIRE(sigh.empty());
+}
@@ -0,0 +1,116 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <container/small_vector.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+TEST_CASE("SmallVector_Inline", "[SmallVector]") {
+    escad::small_vector<std::string, 2u> vec;
+
+    ASSERT_TRUE(vec.empty());
+    ASSERT_TRUE(vec.is_inline());
+    ASSERT_EQ(vec.capacity(), 2u);
+
+    vec.push_back("foo");
+    vec.emplace_back("bar");
+
+    ASSERT_EQ(vec.size(), 2u);
+    ASSERT_TRUE(vec.is_inline());
+    ASSERT_EQ(vec[0u], "foo");
+    ASSERT_EQ(vec[1u], "bar");
+
+    vec.push_back("quux");
+
+    ASSERT_FALSE(vec.is_inline());
+    ASSERT_EQ(vec.size(), 3u);
+    ASSERT_EQ(vec.capacity(), 4u);
+    ASSERT_EQ(vec[2u], "quux");
+
+    vec.clear();
+
+    ASSERT_TRUE(vec.empty());
+    ASSERT_FALSE(vec.is_inline());
+}
+
+TEST_CASE("SmallVector_InsertErase", "[SmallVector]") {
+    escad::small_vector<int, 3u> vec;
+
+    vec.push_back(1);
+    vec.push_back(3);
+
+    auto it = vec.insert(vec.cbegin() + 1, 2);
+
+    ASSERT_EQ(*it, 2);
+    ASSERT_EQ(vec.size(), 3u);
+
+    vec.insert(vec.cbegin(), 0);
+
+    ASSERT_EQ(vec.size(), 4u);
+
+    for(int i = 0; i < 4; ++i) {
+        ASSERT_EQ(vec[static_cast<std::size_t>(i)], i);
+    }
+
+    it = vec.erase(vec.cbegin() + 1, vec.cbegin() + 3);
+
+    ASSERT_EQ(*it, 3);
+    ASSERT_EQ(vec.size(), 2u);
+    ASSERT_EQ(vec[0u], 0);
+    ASSERT_EQ(vec[1u], 3);
+
+    vec.erase(vec.cbegin());
+
+    ASSERT_EQ(vec.size(), 1u);
+    ASSERT_EQ(vec[0u], 3);
+}
+
+TEST_CASE("SmallVector_CopyMove", "[SmallVector]") {
+    escad::small_vector<std::unique_ptr<int>, 2u> vec;
+    vec.push_back(std::make_unique<int>(1));
+
+    escad::small_vector<std::unique_ptr<int>, 2u> other{std::move(vec)};
+
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(*other[0u], 1);
+
+    other.push_back(std::make_unique<int>(2));
+    other.push_back(std::make_unique<int>(3));
+
+    const auto *data = other.data();
+    vec = std::move(other);
+
+    // spilled storage is taken over
+    ASSERT_EQ(vec.data(), data);
+    ASSERT_TRUE(other.empty());
+    ASSERT_TRUE(other.is_inline());
+
+    other.push_back(std::make_unique<int>(4));
+    vec.swap(other);
+
+    ASSERT_EQ(vec.size(), 1u);
+    ASSERT_EQ(other.size(), 3u);
+    ASSERT_EQ(*vec[0u], 4);
+    ASSERT_EQ(*other[2u], 3);
+
+    escad::small_vector<std::string, 1u> strings;
+    strings.push_back("foo");
+    strings.push_back("bar");
+
+    auto copy = strings;
+
+    ASSERT_EQ(copy.size(), 2u);
+    ASSERT_EQ(copy[1u], "bar");
+
+    copy = escad::small_vector<std::string, 1u>{};
+    copy.push_back("quux");
+    strings = copy;
+
+    ASSERT_EQ(strings.size(), 1u);
+    ASSERT_EQ(strings[0u], "quux");
+}
@@ -0,0 +1,117 @@
+#include <array>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <signal/static_emitter.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+struct foo_event {
+    int i;
+};
+
+struct bar_event {};
+
+struct test_emitter: escad::static_emitter<test_emitter, foo_event, bar_event> {
+    int published{};
+};
+
+TEST_CASE("StaticEmitter_On", "[StaticEmitter]") {
+    test_emitter emitter;
+    int value{};
+
+    ASSERT_TRUE(emitter.empty());
+    ASSERT_EQ(test_emitter::size(), 2u);
+
+    emitter.on<foo_event>([&value](foo_event &event, test_emitter &owner) {
+        value = event.i;
+        ++owner.published;
+    });
+
+    ASSERT_FALSE(emitter.empty());
+    ASSERT_TRUE(emitter.contains<foo_event>());
+    ASSERT_FALSE(emitter.contains<bar_event>());
+
+    emitter.publish(foo_event{42});
+    emitter.publish(bar_event{});
+
+    ASSERT_EQ(value, 42);
+    ASSERT_EQ(emitter.published, 1);
+
+    foo_event event{3};
+    emitter.publish(event);
+
+    ASSERT_EQ(value, 3);
+    ASSERT_EQ(emitter.published, 2);
+}
+
+TEST_CASE("StaticEmitter_LargeListener", "[StaticEmitter]") {
+    test_emitter emitter;
+    std::array<int, 16u> values{};
+    int value{};
+
+    values.back() = 3;
+    emitter.on<foo_event>([values, &value](foo_event &event, test_emitter &) { value = event.i * values.back(); });
+
+    test_emitter other{std::move(emitter)};
+    other.publish(foo_event{42});
+
+    ASSERT_EQ(value, 126);
+    ASSERT_TRUE(other.contains<foo_event>());
+}
+
+TEST_CASE("StaticEmitter_Replace", "[StaticEmitter]") {
+    test_emitter emitter;
+    int first{};
+    int second{};
+
+    emitter.on<bar_event>([&first](auto &, auto &) { ++first; });
+    emitter.on<bar_event>([&second](auto &, auto &) { ++second; });
+    emitter.publish(bar_event{});
+
+    ASSERT_EQ(first, 0);
+    ASSERT_EQ(second, 1);
+}
+
+TEST_CASE("StaticEmitter_EraseAndClear", "[StaticEmitter]") {
+    test_emitter emitter;
+
+    emitter.on<foo_event>([](auto &, auto &) {});
+    emitter.on<bar_event>([](auto &, auto &) {});
+    emitter.erase<foo_event>();
+
+    ASSERT_FALSE(emitter.contains<foo_event>());
+    ASSERT_TRUE(emitter.contains<bar_event>());
+
+    emitter.clear();
+
+    ASSERT_TRUE(emitter.empty());
+}
+
+TEST_CASE("StaticEmitter_MoveAndSwap", "[StaticEmitter]") {
+    test_emitter emitter;
+    test_emitter *owner{};
+
+    emitter.on<foo_event>([&owner](auto &, test_emitter &ref) { owner = &ref; });
+
+    test_emitter other{std::move(emitter)};
+
+    ASSERT_TRUE(emitter.empty());
+    ASSERT_TRUE(other.contains<foo_event>());
+
+    other.publish(foo_event{});
+
+    ASSERT_EQ(owner, &other);
+
+    emitter.swap(other);
+
+    ASSERT_TRUE(emitter.contains<foo_event>());
+    ASSERT_TRUE(other.empty());
+
+    emitter.publish(foo_event{});
+
+    ASSERT_EQ(owner, &emitter);
+}
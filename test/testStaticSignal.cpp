@@ -0,0 +1,158 @@
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <signal/static_signal.h>
+
+#define ASSERT_EQ(EXPR1, EXPR2) REQUIRE(EXPR1 == EXPR2)
+#define ASSERT_TRUE(EXPR) REQUIRE(EXPR)
+#define ASSERT_FALSE(EXPR) REQUIRE_FALSE(EXPR)
+
+struct static_listener {
+    static void add(int &total, int value) {
+        total += value;
+    }
+
+    static void twice(int &total, int value) {
+        total += 2 * value;
+    }
+
+    // drops the trailing argument
+    static void increment(int &total) {
+        ++total;
+    }
+
+    static int square(int value) {
+        return value * value;
+    }
+
+    static int negate(int value) {
+        return -value;
+    }
+
+    static void count(int) {
+        ++calls;
+    }
+
+    void record(int value) {
+        last = value;
+    }
+
+    int last{};
+
+    static inline int calls{};
+};
+
+template<int Value>
+void push_back(std::vector<int> &order) {
+    order.push_back(Value);
+}
+
+TEST_CASE("StaticSignal_Size", "[StaticSignal]") {
+    using empty = escad::static_signal<void(int)>;
+    using sig = escad::static_signal<void(int &, int), &static_listener::add, &static_listener::twice>;
+
+    ASSERT_TRUE(empty::empty());
+    ASSERT_EQ(empty::size(), 0u);
+    ASSERT_FALSE(sig::empty());
+    ASSERT_EQ(sig::size(), 2u);
+
+    static_assert(sig::size() == 2u);
+
+    // publishing with no listeners is a no-op
+    empty::publish(42);
+}
+
+TEST_CASE("StaticSignal_Publish", "[StaticSignal]") {
+    using sig = escad::static_signal<void(int &, int), &static_listener::add, &static_listener::twice, &static_listener::increment>;
+    int total{};
+
+    sig::publish(total, 3);
+
+    ASSERT_EQ(total, 10);
+
+    sig::publish(total, 1);
+
+    ASSERT_EQ(total, 14);
+}
+
+TEST_CASE("StaticSignal_PublishOrder", "[StaticSignal]") {
+    using sig = escad::static_signal<void(std::vector<int> &), &push_back<1>, &push_back<2>, &push_back<3>>;
+    std::vector<int> order{};
+
+    sig::publish(order);
+
+    ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_CASE("StaticSignal_Members", "[StaticSignal]") {
+    using sig = escad::static_signal<void(static_listener &, int), &static_listener::record>;
+    static_listener listener{};
+
+    sig::publish(listener, 42);
+
+    ASSERT_EQ(listener.last, 42);
+}
+
+TEST_CASE("StaticSignal_Collect", "[StaticSignal]") {
+    using sig = escad::static_signal<int(int), &static_listener::square, &static_listener::negate>;
+    std::vector<int> values{};
+
+    sig::collect([&values](int value) { values.push_back(value); }, 3);
+
+    ASSERT_EQ(values, (std::vector<int>{9, -3}));
+
+    values.clear();
+    sig::collect([&values](int value) { values.push_back(value); return true; }, 3);
+
+    ASSERT_EQ(values, (std::vector<int>{9}));
+}
+
+TEST_CASE("StaticSignal_CollectVoid", "[StaticSignal]") {
+    using sig = escad::static_signal<void(int), &static_listener::count, &static_listener::count>;
+    int cnt{};
+
+    static_listener::calls = 0;
+    sig::collect([&cnt]() { ++cnt; }, 0);
+
+    ASSERT_EQ(cnt, 2);
+    ASSERT_EQ(static_listener::calls, 2);
+
+    cnt = 0;
+    static_listener::calls = 0;
+    sig::collect([&cnt]() { ++cnt; return true; }, 0);
+
+    ASSERT_EQ(cnt, 1);
+    ASSERT_EQ(static_listener::calls, 1);
+}
+
+TEST_CASE("StaticSignal_PublishBatch", "[StaticSignal]") {
+    using sig = escad::static_signal<void(int), &static_listener::count, &static_listener::count>;
+    const std::array<int, 3u> batch{1, 2, 3};
+
+    static_listener::calls = 0;
+    sig::publish_batch(batch);
+
+    ASSERT_EQ(static_listener::calls, 6);
+
+    sig::publish_batch(batch.begin(), batch.begin());
+
+    ASSERT_EQ(static_listener::calls, 6);
+}
+
+TEST_CASE("StaticSignal_CollectBatch", "[StaticSignal]") {
+    using sig = escad::static_signal<int(int), &static_listener::square, &static_listener::negate>;
+    const std::vector<int> batch{1, 2, 3};
+    std::vector<int> values{};
+
+    sig::collect_batch([&values](int value) { values.push_back(value); }, batch);
+
+    ASSERT_EQ(values, (std::vector<int>{1, 4, 9, -1, -2, -3}));
+
+    values.clear();
+    sig::collect_batch([&values](int value) { values.push_back(value); return value == 4; }, batch);
+
+    ASSERT_EQ(values, (std::vector<int>{1, 4}));
+}